@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "input_event.hpp"
+
+namespace NGameEngine {
+
+using TActionId = uint16_t;
+
+static constexpr TActionId kInvalidAction =
+    std::numeric_limits<TActionId>::max();
+
+// NOTE: maps device keys to named actions. Bindings are read once into a
+// flat table indexed by device and key, so handling an input event is one
+// lookup and one store. Game code polls action state every update instead
+// of registering callbacks.
+//
+// Binding file, one binding per line, '#' starts a comment:
+//     <action> <keyboard|mouse> <key> [scale]
+// Keyboard keys are A..Z and SPACE, mouse keys are LEFT, RIGHT and MIDDLE.
+// An action value is the sum of scales of its held keys, an action is held
+// while any of its keys is, even if their scales cancel out.
+class TActionMap {
+  public:
+    TActionMap();
+
+    // NOTE: replaces current bindings, returns false and keeps them on error.
+    // Action state is rebuilt from the keys held at the time, without edges.
+    bool load(const std::string& path);
+    bool parse(std::istream& in, std::string_view source);
+
+    void onInputEvent(const TInputEvent& event);
+    // NOTE: call once the game has seen this update's edges
+    void clearEdges();
+
+  public:
+    TActionId action(std::string_view name) const;
+
+    float value(TActionId action) const;
+    bool held(TActionId action) const;
+    // edges since the last clearEdges call
+    bool pressed(TActionId action) const;
+    bool released(TActionId action) const;
+
+  private:
+    struct TBinding {
+        TActionId action = kInvalidAction;
+        float scale      = 0.f;
+    };
+
+    struct TActionState {
+        float value        = 0.f;
+        uint32_t held_keys = 0;
+        bool pressed       = false;
+        bool released      = false;
+    };
+
+    static constexpr size_t kDeviceCount =
+        static_cast<size_t>(EInputDevice::INPUT_DEVICE_COUNT);
+    static constexpr size_t kKeyCount = static_cast<size_t>(EKey::KEY_COUNT);
+
+  private:
+    std::array<TBinding, kDeviceCount * kKeyCount> bindings_;
+    // NOTE: tracked for every key, bound or not, so that reloaded bindings
+    // start from the real key state
+    std::array<bool, kDeviceCount * kKeyCount> keys_down_{};
+    std::vector<std::string> names_;
+    std::vector<TActionState> states_;
+};
+
+}  // namespace NGameEngine
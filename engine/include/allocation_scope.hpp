@@ -0,0 +1,20 @@
+#pragma once
+
+namespace NGameEngine {
+
+// NOTE: names the engine subsystem running on the calling thread, so that a
+// global operator new hook (see tools/alloc_check.cpp) can attribute heap
+// traffic. Labels are string literals and are compared by pointer. Scopes
+// are only set when the engine is built with GACHIBALL_TRACK_ALLOCATIONS.
+void SetAllocationScope(const char* name);
+// returns nullptr outside of labelled code
+const char* CurrentAllocationScope();
+
+}  // namespace NGameEngine
+
+#ifdef GACHIBALL_TRACK_ALLOCATIONS
+#define GACHIBALL_ALLOCATION_SCOPE(name) \
+    ::NGameEngine::SetAllocationScope(name)
+#else
+#define GACHIBALL_ALLOCATION_SCOPE(name) ((void)0)
+#endif
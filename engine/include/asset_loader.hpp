@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "delegate.hpp"
+#include "mesh.hpp"
+#include "window.hpp"
+
+namespace NGameEngine {
+
+struct TAssetLoaderSettings {
+    // NOTE: threads reading and decoding sources, at least one
+    int io_threads = 2;
+    // NOTE: upload from a thread with a second context sharing objects with
+    // the main one. Without it, or if the context can not be created, the
+    // main thread uploads one mesh per frame.
+    bool upload_context = true;
+};
+
+// NOTE: builds the source of a mesh, runs on an I/O thread. Returns nullopt
+// on failure after printing why.
+using TMeshDecoder = TDelegate<std::optional<TMeshSource>()>;
+
+// NOTE: state of one load, shared with the mesh handed out for it
+struct TMeshRequest;
+
+// NOTE: loads meshes without stalling frames. I/O threads read and decode
+// sources, the upload thread turns them into buffers and fences them, and
+// update() creates the vertex arrays, which contexts do not share, once the
+// fences have signaled. A loaded mesh is handed out at once and draws
+// nothing until it is ready.
+class TAssetLoader {
+  public:
+    TAssetLoader() = default;
+    ~TAssetLoader();
+
+    TAssetLoader(const TAssetLoader&)            = delete;
+    TAssetLoader& operator=(const TAssetLoader&) = delete;
+
+    // NOTE: main thread, the context of the window must be current
+    void init(TWindow* window, const TAssetLoaderSettings& settings);
+    // NOTE: loads in flight are dropped and their meshes stay empty
+    void deinit();
+
+    // NOTE: a cooked mesh file, see ReadMeshFile
+    std::unique_ptr<IMesh> loadMesh(std::string path);
+    std::unique_ptr<IMesh> loadMesh(TMeshDecoder decoder);
+
+    // NOTE: main thread, once per frame. Never waits on the loader threads
+    // or the GPU, whatever is not ready is looked at again next frame.
+    void update();
+
+  public:
+    // getters
+    // loads which have neither finished nor failed
+    size_t pendingCount() const;
+
+  private:
+    using TRequestPtr = std::shared_ptr<TMeshRequest>;
+
+  private:
+    void ioLoop();
+    void uploadLoop();
+    // NOTE: on the thread with the upload context current
+    void upload(TMeshRequest& request);
+    // NOTE: returns false while the fence of the request has not signaled
+    bool finish(TMeshRequest& request);
+
+  private:
+    std::unique_ptr<TWindow> upload_context_;
+    std::vector<std::thread> io_threads_;
+    std::thread upload_thread_;
+
+    std::mutex mutex_;
+    std::condition_variable decode_ready_;
+    std::condition_variable upload_ready_;
+    std::deque<TRequestPtr> decode_queue_;
+    std::deque<TRequestPtr> upload_queue_;
+    // NOTE: fenced uploads waiting for the main thread to take them
+    std::vector<TRequestPtr> uploaded_;
+    bool stop_ = false;
+
+    // NOTE: main thread only
+    std::vector<TRequestPtr> fenced_;
+    std::atomic<size_t> pending_{0};
+};
+
+}  // namespace NGameEngine
@@ -10,6 +10,13 @@ class ICamera {
     virtual ~ICamera() = default;
 
     virtual glm::mat4x4 view() const = 0;
+
+    // NOTE: the view once cursor motion which has been polled but not yet
+    // dispatched reaches the camera, used to late latch the frame. Must not
+    // change the camera, the motion still arrives as a MOVED event.
+    virtual glm::mat4x4 latchedView(float x_delta, float y_delta) const {
+        return view();
+    }
 };
 
 std::unique_ptr<ICamera> CreateRotatingCamera(
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include "mesh.hpp"
+
+namespace NGameEngine {
+
+// NOTE: engine components, each system streams only the columns it needs.
+// Entities with a transform and a mesh are drawn, a velocity moves the
+// transform and a mass makes the entity subject to gravity.
+
+// NOTE: relative to the parent body, if any
+struct TTransform {
+    glm::vec3 position = glm::vec3{0.f};
+    glm::quat rotation = glm::quat{1.f, 0.f, 0.f, 0.f};
+};
+
+struct TVelocity {
+    glm::vec3 linear       = glm::vec3{0.f};
+    glm::vec3 acceleration = glm::vec3{0.f};
+};
+
+struct TMass {
+    float mass     = 0.f;
+    float mass_inv = 0.f;
+};
+
+struct TMeshRef {
+    IMesh* mesh = nullptr;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace NGameEngine {
+
+static constexpr size_t kDelegateBufferSize = 4 * sizeof(void*);
+
+// NOTE: move only replacement of std::function which keeps the callable in an
+// inline buffer, a callable which does not fit is a compile error rather than
+// a hidden heap allocation
+template <typename TSignature, size_t BufferSize = kDelegateBufferSize>
+class TDelegate;
+
+template <typename TResult, typename... TArgs, size_t BufferSize>
+class TDelegate<TResult(TArgs...), BufferSize> {
+  public:
+    TDelegate() = default;
+
+    template <typename TCallable>
+        requires(!std::is_same_v<std::decay_t<TCallable>, TDelegate>) &&
+                std::is_invocable_r_v<
+                    TResult,
+                    std::decay_t<TCallable>&,
+                    TArgs...>
+    TDelegate(TCallable&& callable) {
+        using TStored = std::decay_t<TCallable>;
+        static_assert(
+            sizeof(TStored) <= BufferSize,
+            "callable does not fit the delegate buffer"
+        );
+        static_assert(
+            alignof(TStored) <= alignof(std::max_align_t),
+            "callable is overaligned"
+        );
+        static_assert(
+            std::is_nothrow_move_constructible_v<TStored>,
+            "callable must be nothrow movable"
+        );
+
+        new (buffer_) TStored(std::forward<TCallable>(callable));
+        invoke_ = [](void* storage, TArgs... args) -> TResult {
+            return (*static_cast<TStored*>(storage))(
+                std::forward<TArgs>(args)...
+            );
+        };
+        relocate_ = [](void* to, void* from) {
+            auto* callable = static_cast<TStored*>(from);
+            new (to) TStored(std::move(*callable));
+            callable->~TStored();
+        };
+        destroy_ = [](void* storage) {
+            static_cast<TStored*>(storage)->~TStored();
+        };
+    }
+
+    TDelegate(TDelegate&& other) noexcept {
+        moveFrom(other);
+    }
+
+    TDelegate& operator=(TDelegate&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    TDelegate(const TDelegate&)            = delete;
+    TDelegate& operator=(const TDelegate&) = delete;
+
+    ~TDelegate() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return invoke_ != nullptr;
+    }
+
+    TResult operator()(TArgs... args) const {
+        return invoke_(buffer_, std::forward<TArgs>(args)...);
+    }
+
+    void reset() {
+        if (destroy_) {
+            destroy_(buffer_);
+        }
+        invoke_   = nullptr;
+        relocate_ = nullptr;
+        destroy_  = nullptr;
+    }
+
+  private:
+    void moveFrom(TDelegate& other) {
+        if (!other.invoke_) {
+            return;
+        }
+        other.relocate_(buffer_, other.buffer_);
+        invoke_   = std::exchange(other.invoke_, nullptr);
+        relocate_ = std::exchange(other.relocate_, nullptr);
+        destroy_  = std::exchange(other.destroy_, nullptr);
+    }
+
+  private:
+    alignas(std::max_align_t) mutable std::byte buffer_[BufferSize];
+
+    TResult (*invoke_)(void*, TArgs...) = nullptr;
+    void (*relocate_)(void*, void*)     = nullptr;
+    void (*destroy_)(void*)             = nullptr;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace NGameEngine {
+
+struct TDynamicResolutionSettings {
+    bool enabled = true;
+
+    // NOTE: fraction of window size per axis
+    float min_scale = 0.5f;
+    float max_scale = 1.f;
+
+    double target_frame_time_ms = 1000. / 60.;
+};
+
+// NOTE: picks render scale so that measured frame time fits the budget
+class TDynamicResolution {
+  public:
+    TDynamicResolution() = default;
+
+    void init(const TDynamicResolutionSettings& settings);
+
+    void update(double frame_time_ms);
+
+  public:
+    // getters
+    bool enabled() const;
+    float scale() const;
+
+  private:
+    TDynamicResolutionSettings settings_;
+
+    float scale_                 = 1.f;
+    double smoothed_frame_time_  = 0.;
+    int frames_since_adjustment_ = 0;
+};
+
+}  // namespace NGameEngine
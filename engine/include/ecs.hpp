@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "slot_map.hpp"
+#include "task_pool.hpp"
+
+namespace NGameEngine {
+
+using TEntity        = TSlotHandle;
+using TComponentId   = uint32_t;
+using TComponentMask = uint64_t;
+
+static constexpr TEntity kInvalidEntity{};
+static constexpr size_t kMaxComponentTypes = 64;
+// NOTE: rows per task of parallel queries
+static constexpr size_t kEcsChunkSize = 1024;
+
+// NOTE: ids are handed out on first use, the size is kept for type erased
+// row moves
+TComponentId RegisterComponent(size_t size);
+size_t ComponentSize(TComponentId component);
+
+template <typename T>
+TComponentId ComponentId() {
+    static_assert(
+        std::is_trivially_copyable_v<T>, "components are moved with memcpy"
+    );
+    static_assert(
+        alignof(T) <= alignof(std::max_align_t),
+        "component columns are allocated with the default alignment"
+    );
+
+    static const TComponentId id = RegisterComponent(sizeof(T));
+    return id;
+}
+
+template <typename... Ts>
+TComponentMask ComponentMask() {
+    return (
+        TComponentMask{0} | ... |
+        (TComponentMask{1} << ComponentId<std::remove_const_t<Ts>>())
+    );
+}
+
+// NOTE: table of the entities with exactly the same set of components, one
+// contiguous column per component. Row i of every column belongs to
+// entities[i].
+struct TArchetype {
+    struct TColumn {
+        TComponentId component;
+        size_t stride;
+        std::vector<std::byte> data;
+    };
+
+    TComponentMask mask = 0;
+    std::vector<TEntity> entities;
+    std::vector<TColumn> columns;
+    // NOTE: column of every component id, -1 if absent
+    std::array<int8_t, kMaxComponentTypes> column_index;
+
+    template <typename T>
+    std::span<T> column() {
+        auto index = column_index[ComponentId<std::remove_const_t<T>>()];
+        assert(index >= 0);
+        return {
+            reinterpret_cast<T*>(columns[index].data.data()), entities.size()
+        };
+    }
+};
+
+// NOTE: entities are handles into a slot map of table locations, so adding
+// or removing components moves the row to another table without changing
+// the entity. Structural changes (create, destroy, add, remove) invalidate
+// component pointers and must not happen inside a query.
+class TWorld {
+  public:
+    TWorld() = default;
+
+    TWorld(const TWorld&)            = delete;
+    TWorld& operator=(const TWorld&) = delete;
+
+    template <typename... Ts>
+    TEntity create(Ts... components) {
+        auto entity = createEntity(ComponentMask<Ts...>());
+        (assign(entity, components), ...);
+        return entity;
+    }
+
+    // NOTE: stale entities are ignored
+    void destroy(TEntity entity);
+    bool alive(TEntity entity) const;
+
+    // NOTE: components the entity already has are overwritten
+    template <typename... Ts>
+    void add(TEntity entity, Ts... components) {
+        if (!alive(entity)) {
+            return;
+        }
+        setMask(entity, mask(entity) | ComponentMask<Ts...>());
+        (assign(entity, components), ...);
+    }
+
+    template <typename... Ts>
+    void remove(TEntity entity) {
+        if (!alive(entity)) {
+            return;
+        }
+        setMask(entity, mask(entity) & ~ComponentMask<Ts...>());
+    }
+
+    template <typename T>
+    bool has(TEntity entity) const {
+        return alive(entity) && (mask(entity) & ComponentMask<T>());
+    }
+
+    // NOTE: nullptr for stale entities and missing components
+    template <typename T>
+    T* get(TEntity entity) {
+        return static_cast<T*>(
+            componentData(entity, ComponentId<std::remove_const_t<T>>())
+        );
+    }
+
+    // NOTE: calls func(std::span<Ts>...) for every table which has all the
+    // components, other columns are not touched. Const components are
+    // read only.
+    template <typename... Ts, typename TFunc>
+    void eachChunk(TFunc&& func) {
+        static_assert(sizeof...(Ts) > 0, "query needs a component");
+
+        auto mask = ComponentMask<Ts...>();
+        for (auto& archetype : archetypes_) {
+            if ((archetype.mask & mask) == mask &&
+                !archetype.entities.empty()) {
+                func(archetype.column<Ts>()...);
+            }
+        }
+    }
+
+    // NOTE: calls func(Ts&...) for every entity which has the components
+    template <typename... Ts, typename TFunc>
+    void each(TFunc&& func) {
+        eachChunk<Ts...>([&func](std::span<Ts>... columns) {
+            auto size = std::get<0>(std::tie(columns...)).size();
+            for (size_t i = 0; i < size; ++i) {
+                func(columns[i]...);
+            }
+        });
+    }
+
+    // NOTE: same as eachChunk, tables are split into chunks of
+    // kEcsChunkSize rows which run on the task pool
+    template <typename... Ts, typename TFunc>
+    void parallelEachChunk(TTaskPool* task_pool, TFunc&& func) {
+        static_assert(sizeof...(Ts) > 0, "query needs a component");
+
+        auto mask = ComponentMask<Ts...>();
+        chunks_.clear();
+        for (uint32_t i = 0; i < archetypes_.size(); ++i) {
+            if ((archetypes_[i].mask & mask) != mask) {
+                continue;
+            }
+            auto size = archetypes_[i].entities.size();
+            for (size_t begin = 0; begin < size; begin += kEcsChunkSize) {
+                chunks_.push_back(TChunk{
+                    .archetype = i,
+                    .begin     = begin,
+                    .size      = std::min(kEcsChunkSize, size - begin),
+                });
+            }
+        }
+
+        task_pool->parallelFor(chunks_.size(), [this, &func](size_t i) {
+            const auto& chunk = chunks_[i];
+            auto& archetype   = archetypes_[chunk.archetype];
+            func(archetype.column<Ts>().subspan(chunk.begin, chunk.size)...);
+        });
+    }
+
+  public:
+    // getters
+    size_t entityCount() const;
+    size_t archetypeCount() const;
+    // heap bytes of the tables, reserved capacity included
+    size_t memoryUsage() const;
+
+  private:
+    struct TLocation {
+        uint32_t archetype;
+        uint32_t row;
+    };
+
+    struct TChunk {
+        uint32_t archetype;
+        size_t begin;
+        size_t size;
+    };
+
+  private:
+    TEntity createEntity(TComponentMask mask);
+    TComponentMask mask(TEntity entity) const;
+    // NOTE: moves the entity to the table of the mask, shared components
+    // are copied and new ones are zeroed
+    void setMask(TEntity entity, TComponentMask mask);
+    void* componentData(TEntity entity, TComponentId component);
+
+    uint32_t findOrCreateArchetype(TComponentMask mask);
+    uint32_t pushRow(uint32_t archetype, TEntity entity);
+    // NOTE: swap remove, fixes the location of the entity moved into the hole
+    void removeRow(uint32_t archetype, uint32_t row);
+
+    template <typename T>
+    void assign(TEntity entity, const T& component) {
+        *get<T>(entity) = component;
+    }
+
+  private:
+    std::vector<TArchetype> archetypes_;
+    std::unordered_map<TComponentMask, uint32_t> archetype_by_mask_;
+    TSlotMap<TLocation> locations_;
+
+    // NOTE: kept between queries to avoid allocations
+    std::vector<TChunk> chunks_;
+};
+
+}  // namespace NGameEngine
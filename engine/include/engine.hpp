@@ -1,16 +1,26 @@
 #pragma once
 
-#include <functional>
 #include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
-#include "body.hpp"
+#include "action_map.hpp"
+#include "asset_loader.hpp"
 #include "camera.hpp"
+#include "components.hpp"
+#include "delegate.hpp"
+#include "ecs.hpp"
+#include "event.hpp"
+#include "event_bus.hpp"
 #include "game.hpp"
+#include "gpu_timer.hpp"
 #include "input_event.hpp"
+#include "settings.hpp"
 
 namespace NGameEngine {
 
-using TInputCallback = std::function<void(TInputEvent)>;
+using TInputCallback = TDelegate<void(const TInputEvent&)>;
 
 class TGameEngineImpl;
 
@@ -19,22 +29,60 @@ class TGameEngine {
     TGameEngine();
     ~TGameEngine();
 
-    void init();
+    void init(TEngineSettings settings = {});
     void deinit();
     void run(IGame* game);
 
   public:
     void bindCamera(const ICamera* camera);
 
-    void addBody(TBody* body);
-    void addBody(TRigidBody* body);
-    void removeBody(TBody* body);
+    // NOTE: creates an entity with a transform placed in the scene graph,
+    // further components are added through world(). The parent must be a
+    // body which is still alive.
+    TEntity addBody(
+        const TTransform& transform, TEntity parent = kInvalidEntity
+    );
+    // NOTE: stale entities are ignored
+    void removeBody(TEntity entity);
+    TWorld& world();
+
+    // NOTE: loads in the background and returns the mesh at once, it draws
+    // nothing until its data is on the GPU. Files are cooked meshes, other
+    // sources come from a decoder, e.g. BallMeshSource.
+    std::unique_ptr<IMesh> loadMesh(std::string path);
+    std::unique_ptr<IMesh> loadMesh(TMeshDecoder decoder);
+    // NOTE: loads still in flight, e.g. for a loading screen
+    size_t pendingAssetCount() const;
+
+    void grabCursor();
+    void ungrabCursor();
+
+    // NOTE: bindings used by actions(), can be reloaded at any time
+    bool loadActionMap(const std::string& path);
+    const TActionMap& actions() const;
 
-    void registerInputCallback(
+    TEventSubscription registerInputCallback(
         TInputEventType inputEventType, TInputCallback callback
     );
+    void unregisterInputCallback(TEventSubscription subscription);
+    // NOTE: removes every callback of the event type
     void unregisterInputCallback(TInputEventType inputEventType);
 
+    // NOTE: raw cursor reports behind this frame's MOVED event, for consumers
+    // which need sub-frame timing
+    std::span<const TMouseMotionSample> mouseMotionSamples() const;
+
+    // NOTE: typed engine and game events, delivered once per frame after input
+    TEventBus& eventBus();
+
+    // NOTE: per pass GPU time of a recently completed frame
+    const std::vector<TGpuPassTiming>& gpuTimings() const;
+
+    // NOTE: writes recent CPU zones of all threads as a Chrome trace to the
+    // profile path of the settings. Empty unless the engine is built with
+    // GACHIBALL_PROFILING.
+    bool exportProfile();
+
   private:
     std::unique_ptr<TGameEngineImpl> impl_;
 };
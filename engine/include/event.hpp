@@ -1,14 +1,30 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <variant>
 
 #include "input_event.hpp"
 
 namespace NGameEngine {
 
+struct TWindowResizeEvent {
+    int width;
+    int height;
+};
+
 using TEventType = std::variant<TInputEventType>;
 using TEvent     = std::variant<TInputEvent>;
 
+// NOTE: stays valid until unsubscribed, a stale token is ignored even if its
+// slot was reused by another subscription
+struct TEventSubscription {
+    uint32_t index      = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    bool operator==(const TEventSubscription&) const = default;
+};
+
 template <typename TBaseEventType>
 TEventType MakeEventType(TBaseEventType event_type) {
     return TEventType{std::forward<TBaseEventType>(event_type)};
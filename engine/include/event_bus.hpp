@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "delegate.hpp"
+
+namespace NGameEngine {
+
+using TEventTypeId = uint64_t;
+
+// NOTE: FNV-1a of the function signature, which spells the type name, so the
+// id is the same in every translation unit and needs no registration
+template <typename TEventT>
+consteval TEventTypeId EventTypeId() {
+#if defined(_MSC_VER)
+    std::string_view name = __FUNCSIG__;
+#else
+    std::string_view name = __PRETTY_FUNCTION__;
+#endif
+    TEventTypeId hash = 14695981039346656037ull;
+    for (auto c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+struct TEventBusSubscription {
+    TEventTypeId type = 0;
+    uint32_t id       = 0;
+
+    bool operator==(const TEventBusSubscription&) const = default;
+};
+
+template <typename TEventT>
+using TEventBatchHandler = TDelegate<void(std::span<const TEventT>)>;
+
+class IEventChannel {
+  public:
+    virtual ~IEventChannel() = default;
+
+    // delivers events published since the last call, returns their number
+    virtual size_t deliver() = 0;
+    virtual void unsubscribe(uint32_t id) = 0;
+    virtual size_t subscriberCount() const = 0;
+    // bytes of the channel and its buffers
+    virtual size_t memoryUsage() const = 0;
+};
+
+// NOTE: events of one type are stored contiguously and handed to every
+// handler as one span, handlers of the type live in one array
+template <typename TEventT>
+class TEventChannel final : public IEventChannel {
+  public:
+    uint32_t subscribe(TEventBatchHandler<TEventT> handler) {
+        auto id = next_id_++;
+        // NOTE: handlers_ must not grow while it is iterated
+        auto& handlers = delivering_ ? added_ : handlers_;
+        handlers.push_back({std::move(handler), id, true});
+        return id;
+    }
+
+    void unsubscribe(uint32_t id) override {
+        for (auto* handlers : {&handlers_, &added_}) {
+            for (auto& entry : *handlers) {
+                if (entry.id == id) {
+                    entry.alive = false;
+                }
+            }
+        }
+        if (!delivering_) {
+            compact();
+        }
+    }
+
+    bool hasSubscribers() const {
+        return !handlers_.empty() || !added_.empty();
+    }
+
+    size_t subscriberCount() const override {
+        size_t count = 0;
+        for (const auto* handlers : {&handlers_, &added_}) {
+            count += std::count_if(
+                handlers->begin(),
+                handlers->end(),
+                [](const auto& entry) { return entry.alive; }
+            );
+        }
+        return count;
+    }
+
+    size_t memoryUsage() const override {
+        return sizeof(*this) +
+               (handlers_.capacity() + added_.capacity()) *
+                   sizeof(THandlerEntry) +
+               (pending_.capacity() + delivered_.capacity()) * sizeof(TEventT);
+    }
+
+    void publish(TEventT event) {
+        pending_.push_back(std::move(event));
+    }
+
+    void publishBatch(std::span<const TEventT> events) {
+        pending_.insert(pending_.end(), events.begin(), events.end());
+    }
+
+    size_t deliver() override {
+        if (pending_.empty() || delivering_) {
+            return 0;
+        }
+
+        // NOTE: events published by handlers are delivered next time
+        std::swap(pending_, delivered_);
+        pending_.clear();
+
+        delivering_ = true;
+        std::span<const TEventT> events{delivered_};
+        for (const auto& entry : handlers_) {
+            if (entry.alive) {
+                entry.handler(events);
+            }
+        }
+        delivering_ = false;
+
+        compact();
+        return events.size();
+    }
+
+  private:
+    struct THandlerEntry {
+        TEventBatchHandler<TEventT> handler;
+        uint32_t id;
+        bool alive;
+    };
+
+  private:
+    void compact() {
+        for (auto& entry : added_) {
+            handlers_.push_back(std::move(entry));
+        }
+        added_.clear();
+        std::erase_if(handlers_, [](const auto& entry) {
+            return !entry.alive;
+        });
+        if (handlers_.empty()) {
+            pending_.clear();
+        }
+    }
+
+  private:
+    std::vector<THandlerEntry> handlers_;
+    std::vector<THandlerEntry> added_;
+    uint32_t next_id_ = 0;
+
+    std::vector<TEventT> pending_;
+    std::vector<TEventT> delivered_;
+    bool delivering_ = false;
+};
+
+// NOTE: typed events beside the input dispatcher. Publishing only queues the
+// event, dispatch() delivers every queued type in batches. Publishing a type
+// nobody subscribes to costs a lookup. Not thread safe, use it from the
+// engine thread only.
+class TEventBus {
+  public:
+    TEventBus();
+    ~TEventBus();
+
+  public:
+    template <typename TEventT>
+    TEventBusSubscription subscribe(TEventBatchHandler<TEventT> handler) {
+        auto* channel = static_cast<TEventChannel<TEventT>*>(findOrCreate(
+            EventTypeId<TEventT>(),
+            []() -> std::unique_ptr<IEventChannel> {
+                return std::make_unique<TEventChannel<TEventT>>();
+            }
+        ));
+        return {
+            .type = EventTypeId<TEventT>(),
+            .id   = channel->subscribe(std::move(handler)),
+        };
+    }
+
+    void unsubscribe(TEventBusSubscription subscription);
+
+    template <typename TEventT>
+    void publish(TEventT event) {
+        if (auto* channel = find<TEventT>(); channel) {
+            channel->publish(std::move(event));
+        }
+    }
+
+    template <typename TEventT>
+    void publishBatch(std::span<const TEventT> events) {
+        if (auto* channel = find<TEventT>(); channel) {
+            channel->publishBatch(events);
+        }
+    }
+
+    template <typename TEventT>
+    bool hasSubscribers() const {
+        return find<TEventT>() != nullptr;
+    }
+
+    // returns the number of delivered events
+    size_t dispatch();
+
+  public:
+    // getters
+    // event types which were ever subscribed to
+    size_t channelCount() const;
+    size_t subscriberCount() const;
+    size_t memoryUsage() const;
+
+  private:
+    template <typename TEventT>
+    TEventChannel<TEventT>* find() const {
+        auto* channel = static_cast<TEventChannel<TEventT>*>(
+            findChannel(EventTypeId<TEventT>())
+        );
+        return channel && channel->hasSubscribers() ? channel : nullptr;
+    }
+
+    IEventChannel* findChannel(TEventTypeId type) const;
+    IEventChannel* findOrCreate(
+        TEventTypeId type, std::unique_ptr<IEventChannel> (*create)()
+    );
+
+  private:
+    // sorted by type
+    std::vector<std::pair<TEventTypeId, std::unique_ptr<IEventChannel>>>
+        channels_;
+};
+
+}  // namespace NGameEngine
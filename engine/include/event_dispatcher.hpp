@@ -1,13 +1,13 @@
 #pragma once
 
-#include <functional>
 #include <memory>
 
+#include "delegate.hpp"
 #include "event.hpp"
 
 namespace NGameEngine {
 
-using TEventHandler = std::function<void(TEvent)>;
+using TInputEventHandler = TDelegate<void(const TInputEvent&)>;
 
 class TEventDispatcher {
     class TImpl;
@@ -17,10 +17,31 @@ class TEventDispatcher {
     ~TEventDispatcher();
 
   public:
-    void registerEventHandler(
-        TEventType event_type, TEventHandler event_handler
+    // NOTE: handlers of one event type are called in subscription order, it
+    // is safe to subscribe and unsubscribe from inside a handler, such changes
+    // take effect once the current event is handled
+    TEventSubscription subscribe(
+        TInputEventType event_type, TInputEventHandler event_handler
     );
-    void raiseEvent(TEvent event);
+    void unsubscribe(TEventSubscription subscription);
+    void unsubscribeAll(TInputEventType event_type);
+
+    // NOTE: sees every input event before its subscribers, e.g. to measure
+    void setInputObserver(TInputEventHandler observer);
+
+    // NOTE: handlers run immediately on the calling thread
+    void raiseEvent(const TEvent& event);
+
+    // NOTE: thread safe, the event is handled by the next dispatchEvents call,
+    // returns false and drops the event if the queue is full
+    bool pushEvent(TEvent event);
+    // handles queued events in batches, returns the number of handled events
+    size_t dispatchEvents();
+
+    size_t droppedEventCount() const;
+    size_t subscriptionCount() const;
+    // NOTE: bytes of handler tables and the event queue
+    size_t memoryUsage() const;
 
   private:
     std::unique_ptr<TImpl> impl_;
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace NGameEngine {
+
+// NOTE: bump allocator with a bulk reset, deallocation is a no-op. Requests
+// which do not fit go to the heap and the buffer is grown to cover them at
+// the next reset, so a steady workload stops touching the heap after a few
+// frames. Usable as a std::pmr memory resource.
+class TLinearArena : public std::pmr::memory_resource {
+  public:
+    TLinearArena() = default;
+    ~TLinearArena() override;
+
+    TLinearArena(const TLinearArena&)            = delete;
+    TLinearArena& operator=(const TLinearArena&) = delete;
+
+    void init(size_t capacity);
+    void deinit();
+
+    // NOTE: invalidates everything allocated since the previous reset
+    void reset();
+
+    // NOTE: uninitialized storage, destructors are never run
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(
+            std::is_trivially_destructible_v<T>,
+            "arena memory is released without running destructors"
+        );
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+  public:
+    // getters
+    size_t capacity() const;
+    // bytes allocated since the reset, including the heap fallback
+    size_t used() const;
+    // most bytes used between two resets
+    size_t peak() const;
+
+  protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other
+    ) const noexcept override;
+
+  private:
+    struct TOverflowBlock {
+        void* ptr;
+        size_t bytes;
+        size_t alignment;
+    };
+
+  private:
+    void releaseOverflow();
+
+  private:
+    std::byte* buffer_ = nullptr;
+    size_t capacity_   = 0;
+    size_t offset_     = 0;
+
+    std::vector<TOverflowBlock> overflow_;
+    size_t overflow_bytes_ = 0;
+    size_t peak_           = 0;
+};
+
+// NOTE: two linear arenas used on alternate frames. Allocations stay valid
+// until the end of the next frame, long enough to hand frame data over to
+// a consumer which runs a frame behind.
+class TFrameArena {
+  public:
+    TFrameArena() = default;
+
+    // NOTE: capacity of each of the two arenas
+    void init(size_t capacity);
+    void deinit();
+
+    // NOTE: resets the arena of the frame before the previous one and makes
+    // it current
+    void beginFrame();
+
+    template <typename T>
+    T* allocate(size_t count) {
+        return current()->allocateArray<T>(count);
+    }
+
+    void report(std::ostream& out);
+
+  public:
+    // getters
+    TLinearArena* current();
+    TLinearArena* previous();
+
+  private:
+    std::array<TLinearArena, 2> arenas_;
+    size_t current_ = 0;
+};
+
+}  // namespace NGameEngine
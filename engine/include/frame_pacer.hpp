@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ostream>
+
+#include "histogram.hpp"
+
+namespace NGameEngine {
+
+struct TFramePacerSettings {
+    // NOTE: frames per second, 0 leaves the rate to the swap interval
+    double target_frame_rate = 0.;
+    // NOTE: 0 disables vsync, negative values request adaptive vsync
+    int swap_interval = 1;
+
+    // NOTE: seconds before the deadline when sleeping turns into spinning,
+    // covers the OS scheduler granularity
+    double spin_threshold = 0.002;
+};
+
+// NOTE: releases frames at a fixed rate. Waits sleep most of the way and spin
+// on the clock for the rest, so deadlines are met without burning a core.
+// Slack is how early the frame was ready, negative slack is a missed deadline.
+class TFramePacer {
+  public:
+    TFramePacer() = default;
+
+    // NOTE: sets the swap interval, the GL context must be current
+    void init(const TFramePacerSettings& settings);
+
+    // blocks until the next frame is due
+    void wait();
+    // NOTE: forget the previous frame, e.g. after a pause
+    void reset();
+
+    // NOTE: 0 leaves the rate to the swap interval, takes effect at once
+    void setTargetFrameRate(double target_frame_rate);
+
+    void report(std::ostream& out);
+
+  public:
+    // getters
+    // seconds between this frame and the previous one, the period if capped
+    double frameDelta() const;
+    // seconds the previous frame actually took, including the wait
+    double frameTime() const;
+    double targetFrameRate() const;
+
+  private:
+    TFramePacerSettings settings_;
+    double period_ = 0.;
+
+    double deadline_    = 0.;
+    double last_frame_  = 0.;
+    double frame_delta_ = 0.;
+    double frame_time_  = 0.;
+
+    THistogram slack_ms_;
+    THistogram frame_time_ms_;
+    size_t missed_deadlines_ = 0;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace NGameEngine {
+
+struct TGpuPassTiming {
+    std::string_view name;
+    size_t depth;
+    double elapsed_ms;
+};
+
+// NOTE: GPU timestamps are read back with a delay of a few frames, queries
+// are never waited on. Pass names must outlive the timer (string literals).
+class TGpuTimer {
+    class TImpl;
+
+  public:
+    TGpuTimer();
+    ~TGpuTimer();
+
+    void init();
+    void deinit();
+
+    void beginFrame();
+    void endFrame();
+
+    void beginPass(std::string_view name);
+    void endPass();
+
+  public:
+    // timings of the latest frame whose queries completed
+    const std::vector<TGpuPassTiming>& timings() const;
+    double frameTimeMs() const;
+
+    // prints averages since the previous report and resets them
+    void report(std::ostream& out);
+
+  private:
+    std::unique_ptr<TImpl> impl_;
+};
+
+class TGpuTimerScope {
+  public:
+    TGpuTimerScope(TGpuTimer* timer, std::string_view name);
+    ~TGpuTimerScope();
+
+  private:
+    TGpuTimer* timer_;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NGameEngine {
+
+// NOTE: log-linear buckets, every power of two above min_value is split into
+// sub_buckets linear buckets, so relative error stays below 1 / sub_buckets
+// over the whole range with a fixed amount of memory
+class THistogram {
+  public:
+    THistogram(
+        double min_value   = 0.01,
+        double max_value   = 10000.,
+        size_t sub_buckets = 16
+    );
+
+    void record(double value);
+    void merge(const THistogram& other);
+    void reset();
+
+  public:
+    // getters
+    uint64_t count() const;
+    double min() const;
+    double max() const;
+    double mean() const;
+    // p in [0, 1]
+    double percentile(double p) const;
+
+  private:
+    size_t bucketIndex(double value) const;
+    double bucketValue(size_t index) const;
+
+  private:
+    double min_value_;
+    double max_value_;
+    size_t sub_buckets_;
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    double sum_     = 0.;
+    double min_     = 0.;
+    double max_     = 0.;
+};
+
+}  // namespace NGameEngine
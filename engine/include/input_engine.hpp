@@ -1,12 +1,36 @@
 #pragma once
 
 #include <memory>
+#include <span>
+#include <utility>
+#include <string>
 
 #include "event_dispatcher.hpp"
 #include "window.hpp"
 
 namespace NGameEngine {
 
+struct TInputSettings {
+    // NOTE: one MOVED event per frame instead of one per cursor report
+    bool coalesce_mouse_motion = true;
+    bool raw_mouse_motion      = true;
+    // NOTE: the cursor is polled once more right before the frame takes the
+    // camera view, events stay queued until the next flush
+    bool late_latch = true;
+
+    // NOTE: raw GLFW input is written to record_path, or read from
+    // playback_path instead of GLFW callbacks, playback wins if both are set
+    std::string record_path;
+    std::string playback_path;
+};
+
+struct TMouseMotionSample {
+    double xpos;
+    double ypos;
+    // seconds, glfwGetTime clock
+    double time;
+};
+
 class TInputEngine {
   public:
     class TImpl;
@@ -16,10 +40,28 @@ class TInputEngine {
     ~TInputEngine();
 
     // register callbacks
-    void init(TWindow* window, TEventDispatcher* event_dispatcher);
+    void init(
+        TWindow* window,
+        TEventDispatcher* event_dispatcher,
+        TInputSettings settings = {}
+    );
     // unregister callbacks
     void deinit();
 
+    // NOTE: call after polling, queues the motion accumulated since the last
+    // flush as a single MOVED event
+    void flush();
+
+    // cursor reports of the last flushed frame, in arrival order
+    std::span<const TMouseMotionSample> motionSamples() const;
+
+    // NOTE: cursor delta polled since the last flush, which handlers have
+    // not seen yet. Always zero during playback.
+    std::pair<double, double> pendingMotion() const;
+
+    // NOTE: the whole trace has been replayed
+    bool playbackFinished() const;
+
   private:
     std::unique_ptr<TImpl> impl_;
 };
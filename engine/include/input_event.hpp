@@ -103,6 +103,9 @@ struct TInputEventContext {
 struct TInputEvent {
     TInputEventType type;
     TInputEventContext context;
+    // NOTE: seconds on the glfwGetTime clock when the input was delivered,
+    // the oldest report for coalesced motion
+    double timestamp = 0.;
 };
 
 }  // namespace NGameEngine
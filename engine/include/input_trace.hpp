@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace NGameEngine {
+
+enum class EInputTraceKind : uint8_t {
+    KEY = 0,
+    MOUSE_KEY,
+    CURSOR_POSITION,
+    INPUT_TRACE_KIND_COUNT,
+};
+
+// NOTE: one GLFW input callback. Records are grouped by the input poll they
+// arrived in, time is seconds since the previous poll.
+struct TInputTraceRecord {
+    uint32_t poll;
+    float time;
+    EInputTraceKind kind;
+    // GLFW key or button and action
+    int32_t key    = 0;
+    int32_t action = 0;
+    double xpos    = 0.;
+    double ypos    = 0.;
+};
+
+// NOTE: little-endian binary, a header followed by records. Key records take
+// 17 bytes, cursor records 25 bytes.
+class TInputTraceWriter {
+  public:
+    bool open(const std::string& path);
+    void write(const TInputTraceRecord& record);
+    void close();
+
+  private:
+    std::ofstream out_;
+};
+
+bool ReadInputTrace(
+    const std::string& path, std::vector<TInputTraceRecord>* records
+);
+
+}  // namespace NGameEngine
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "delegate.hpp"
+
+namespace NGameEngine {
+
+struct TIntrospectionSettings {
+    // NOTE: path of the Unix domain socket, empty disables the server
+    std::string socket_path;
+    // NOTE: seconds between two polls of the socket
+    double poll_period = 0.1;
+};
+
+// NOTE: args[0] is the command name, returns false on bad arguments
+using TIntrospectionCommand =
+    TDelegate<bool(std::span<const std::string_view> args, std::ostream& out)>;
+
+// NOTE: line based text protocol on a local socket, e.g.
+// `socat - UNIX-CONNECT:<path>`. Every command line is answered with its
+// output followed by an "ok" or "error" line. Sockets are non-blocking and
+// polled from the engine thread at a low rate, so commands may touch engine
+// state and an idle server costs a clock compare per frame.
+class TIntrospectionServer {
+  public:
+    TIntrospectionServer() = default;
+    ~TIntrospectionServer();
+
+    TIntrospectionServer(const TIntrospectionServer&)            = delete;
+    TIntrospectionServer& operator=(const TIntrospectionServer&) = delete;
+
+    // NOTE: returns false and stays disabled if the socket can not be bound
+    bool init(const TIntrospectionSettings& settings);
+    void deinit();
+
+    void addCommand(
+        std::string name, std::string help, TIntrospectionCommand command
+    );
+
+    // NOTE: now is on the glfwGetTime clock, does nothing until the poll
+    // period has passed
+    void poll(double now);
+
+  public:
+    // getters
+    bool enabled() const;
+    size_t clientCount() const;
+
+  private:
+    struct TClient {
+        int fd;
+        std::string input;
+        std::string output;
+        // NOTE: the client shut down its end, no more input
+        bool closed = false;
+    };
+
+    struct TCommandEntry {
+        std::string name;
+        std::string help;
+        TIntrospectionCommand command;
+    };
+
+  private:
+    void acceptClients();
+    // NOTE: returns false once the client is gone
+    bool readClient(TClient& client);
+    bool flushClient(TClient& client);
+    void execute(std::string_view line, std::string& output);
+
+  private:
+    TIntrospectionSettings settings_;
+    int listen_fd_    = -1;
+    double next_poll_ = 0.;
+
+    std::vector<TClient> clients_;
+    std::vector<TCommandEntry> commands_;
+};
+
+}  // namespace NGameEngine
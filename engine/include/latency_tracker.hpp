@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+
+#include "input_event.hpp"
+
+namespace NGameEngine {
+
+// NOTE: measures input to photon latency. Every input event handled before a
+// frame is submitted is considered reflected by that frame, the frame is
+// done when its fence completes. Fence completion is observed on the CPU
+// after swapBuffers, so the numbers are an upper bound up to scanout.
+class TLatencyTracker {
+    class TImpl;
+
+  public:
+    TLatencyTracker();
+    ~TLatencyTracker();
+
+    void init();
+    void deinit();
+
+  public:
+    void onInputEvent(const TInputEvent& event);
+
+    // call once the draws of the frame are submitted
+    void submitFrame();
+    // collects completed frames
+    void poll();
+
+    // p50/p95/p99 per event type since the last report
+    void report(std::ostream& out);
+
+  private:
+    std::unique_ptr<TImpl> impl_;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace NGameEngine {
+
+enum class EMemoryTag {
+    // NOTE: bodies, i.e. the component tables of the world
+    PHYSICS = 0,
+    RENDER,
+    EVENTS,
+    // NOTE: meshes and other loaded data
+    ASSETS,
+    MEMORY_TAG_COUNT,
+};
+
+enum class EMemoryPool {
+    CPU = 0,
+    GPU,
+    MEMORY_POOL_COUNT,
+};
+
+static constexpr size_t kMemoryTagCount =
+    static_cast<size_t>(EMemoryTag::MEMORY_TAG_COUNT);
+
+struct TMemoryBudgetSettings {
+    // NOTE: bytes per subsystem, 0 is unlimited
+    std::array<size_t, kMemoryTagCount> cpu{};
+    std::array<size_t, kMemoryTagCount> gpu{};
+    // NOTE: exit when a budget is exceeded instead of warning, for devices
+    // which would rather fail early than be killed by the OS later
+    bool strict = false;
+};
+
+// NOTE: byte counters per subsystem and pool, thread safe. GL objects are
+// added where they are allocated and subtracted where they are deleted. CPU
+// usage of engine owned containers is sampled by the engine and set. A
+// counter crossing its budget warns once, or exits in strict mode.
+void SetMemoryBudgets(const TMemoryBudgetSettings& settings);
+void AddMemoryUsage(EMemoryTag tag, EMemoryPool pool, int64_t bytes);
+void SetMemoryUsage(EMemoryTag tag, EMemoryPool pool, size_t bytes);
+size_t MemoryUsage(EMemoryTag tag, EMemoryPool pool);
+
+// used, peak and budget of every counter
+void ReportMemoryUsage(std::ostream& out);
+
+// NOTE: heap bytes held by a vector, reserved capacity included
+template <typename T>
+size_t CapacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+// NOTE: bytes of a GL texture with the sized internal format, unknown
+// formats are counted as 4 bytes per texel
+size_t TextureByteSize(uint32_t format, int width, int height, int levels = 1);
+
+}  // namespace NGameEngine
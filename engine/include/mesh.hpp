@@ -1,9 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "mesh_asset.hpp"
 
 namespace NGameEngine {
 
@@ -17,9 +24,70 @@ class IMesh {
     virtual ~IMesh() = default;
 
     virtual void draw(const glm::mat4& mvp) = 0;
+
+  public:
+    // getters
+    virtual size_t triangleCount() const = 0;
+};
+
+enum class EMeshVertexFormat {
+    // NOTE: TMeshData
+    FLOAT = 0,
+    // NOTE: TMeshAssetVertex, positions normalized to the bounds
+    QUANTIZED,
+    MESH_VERTEX_FORMAT_COUNT,
+};
+
+struct TMeshLayout {
+    EMeshVertexFormat vertex_format = EMeshVertexFormat::FLOAT;
+    EMeshIndexType index_type       = EMeshIndexType::UINT32;
+    size_t vertex_count             = 0;
+    size_t index_count              = 0;
+    // NOTE: quantized positions only
+    glm::vec3 bounds_min{-1.f};
+    glm::vec3 bounds_max{1.f};
+};
+
+// NOTE: mesh data prepared on the CPU, uploaded as is. The blobs point into
+// the storage, which is shared so a source can be passed between threads.
+struct TMeshSource {
+    TMeshLayout layout;
+    std::span<const std::byte> vertices;
+    std::span<const std::byte> indices;
+    std::shared_ptr<const void> storage;
 };
 
+// NOTE: GL objects of an uploaded source, shared by contexts of the share
+// group. The vertex array is not shared and is made by CreateMesh on the
+// drawing context.
+struct TMeshBuffers {
+    TMeshLayout layout;
+    uint32_t shader_program = 0;
+    uint32_t vertex_buffer  = 0;
+    uint32_t index_buffer   = 0;
+    size_t buffer_bytes     = 0;
+};
+
+// NOTE: the stages of mesh creation, split for TAssetLoader. Sources are
+// built on any thread, uploads need a current context and mesh creation the
+// context which draws the mesh.
+TMeshSource PlatformMeshSource();
+TMeshSource BallMeshSource();
+// NOTE: maps a mesh cooked by tools/meshcook, returns nullopt if the file is
+// missing or malformed. Prefault reads the whole file in now instead of on
+// first access.
+std::optional<TMeshSource> ReadMeshFile(
+    const std::string& path, bool prefault = false
+);
+TMeshBuffers UploadMeshSource(const TMeshSource& source);
+std::unique_ptr<IMesh> CreateMesh(const TMeshBuffers& buffers);
+
+// NOTE: all stages at once on the calling thread
+std::unique_ptr<IMesh> CreateMesh(const TMeshSource& source);
 std::unique_ptr<IMesh> CreatePlatformMesh();
 std::unique_ptr<IMesh> CreateBallMesh();
+// NOTE: the blobs go to GL straight from the mapping, returns nullptr if the
+// file can not be read
+std::unique_ptr<IMesh> LoadMesh(const std::string& path);
 
 }  // namespace NGameEngine
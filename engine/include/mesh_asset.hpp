@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace NGameEngine {
+
+// NOTE: cooked mesh file, written by tools/meshcook. The header is followed
+// by the vertex and the index blob, each starting at a page aligned offset,
+// so a mapped file is handed to GL as is. Values are little endian, the
+// version changes with any layout change.
+static constexpr uint32_t kMeshAssetMagic     = 0x48534d47;  // "GMSH"
+static constexpr uint32_t kMeshAssetVersion   = 1;
+static constexpr uint64_t kMeshAssetAlignment = 4096;
+
+enum class EMeshIndexType : uint32_t {
+    UINT16 = 0,
+    UINT32,
+    MESH_INDEX_TYPE_COUNT,
+};
+
+// NOTE: positions are normalized to the bounds, the loader folds the
+// dequantization into the model matrix
+struct TMeshAssetVertex {
+    int16_t position[3];
+    int16_t padding;
+    uint8_t color[4];
+};
+
+struct TMeshAssetHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_stride;
+    EMeshIndexType index_type;
+    uint32_t vertex_count;
+    uint32_t index_count;
+
+    uint64_t vertex_offset;
+    uint64_t vertex_bytes;
+    uint64_t index_offset;
+    uint64_t index_bytes;
+
+    float bounds_min[3];
+    float bounds_max[3];
+};
+
+static_assert(sizeof(TMeshAssetVertex) == 12);
+static_assert(std::is_trivially_copyable_v<TMeshAssetHeader>);
+
+inline uint64_t AlignMeshAssetOffset(uint64_t offset) {
+    return (offset + kMeshAssetAlignment - 1) & ~(kMeshAssetAlignment - 1);
+}
+
+inline size_t MeshIndexSize(EMeshIndexType type) {
+    return type == EMeshIndexType::UINT16 ? sizeof(uint16_t)
+                                          : sizeof(uint32_t);
+}
+
+}  // namespace NGameEngine
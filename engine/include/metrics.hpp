@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#include "histogram.hpp"
+
+namespace NGameEngine {
+
+enum class EMetric {
+    FRAME_TIME_MS = 0,
+    PHYSICS_STEP_MS,
+    DRAW_CALLS,
+    TRIANGLES,
+    EVENTS_DISPATCHED,
+    BODIES_SIMULATED,
+    METRIC_COUNT,
+};
+
+enum class EMetricsFormat {
+    // NOTE: one object per interval
+    JSON_LINES = 0,
+    // NOTE: one row per metric and interval
+    CSV,
+    METRICS_FORMAT_COUNT,
+};
+
+struct TMetricsSettings {
+    bool enabled          = false;
+    EMetricsFormat format = EMetricsFormat::JSON_LINES;
+    // NOTE: empty writes to stdout
+    std::string path;
+    // NOTE: seconds between two exports
+    double period = 10.;
+};
+
+// NOTE: keeps a histogram per metric and periodically writes count,
+// p50/p90/p99 and max of the samples recorded since the previous export.
+// Recording is a no-op while disabled.
+class TMetrics {
+  public:
+    TMetrics();
+
+    // NOTE: now is on the glfwGetTime clock
+    void init(const TMetricsSettings& settings, double now);
+    void deinit();
+
+    void record(EMetric metric, double value);
+    // writes the interval if the period has passed
+    void update(double now);
+
+    // NOTE: records even while the export is disabled, e.g. for an attached
+    // introspection client. Histograms are reset when capturing stops.
+    void setCapture(bool capture);
+    // writes the interval so far as a JSON line, does not reset it
+    void snapshot(std::ostream& out, double now) const;
+
+  public:
+    // getters
+    bool enabled() const;
+
+  private:
+    void reset();
+    void write(double now);
+    void writeJson(std::ostream& out, double now) const;
+    void writeCsv(std::ostream& out, double now);
+
+  private:
+    TMetricsSettings settings_;
+    bool enabled_ = false;
+    bool capture_ = false;
+
+    std::ofstream file_;
+    std::ostream* out_ = nullptr;
+
+    double started_at_       = 0.;
+    double interval_start_   = 0.;
+    bool csv_header_written_ = false;
+
+    std::array<THistogram, static_cast<size_t>(EMetric::METRIC_COUNT)>
+        histograms_;
+};
+
+}  // namespace NGameEngine
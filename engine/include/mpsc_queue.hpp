@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+
+namespace NGameEngine {
+
+// NOTE: bounded lock-free queue, any thread may push, one thread pops.
+// Every cell carries a sequence number which tells whose turn it is: the
+// producer that claimed the position, or the consumer once it is published.
+template <typename T, size_t Capacity>
+class TMpscQueue {
+    static_assert(
+        Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+        "capacity must be a power of two"
+    );
+
+  public:
+    TMpscQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    TMpscQueue(const TMpscQueue&)            = delete;
+    TMpscQueue& operator=(const TMpscQueue&) = delete;
+
+    // returns false if the queue is full
+    bool tryPush(T value) {
+        auto position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& cell    = cells_[position & kMask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff     = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed
+                    )) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(
+                        position + 1, std::memory_order_release
+                    );
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // NOTE: consumer thread only
+    std::optional<T> tryPop() {
+        auto& cell    = cells_[head_ & kMask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != head_ + 1) {
+            return std::nullopt;
+        }
+
+        std::optional<T> value{std::move(cell.value)};
+        cell.sequence.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return value;
+    }
+
+    // NOTE: consumer thread only. Counts positions claimed by producers so
+    // far, some of which may not be published yet.
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_;
+    }
+
+  private:
+    static constexpr size_t kMask = Capacity - 1;
+    // NOTE: keeps producers and the consumer off each other's cache lines
+    static constexpr size_t kCacheLine = 64;
+
+    struct alignas(kCacheLine) TCell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+  private:
+    std::array<TCell, Capacity> cells_;
+    alignas(kCacheLine) std::atomic<size_t> tail_ = 0;
+    alignas(kCacheLine) size_t head_               = 0;
+};
+
+}  // namespace NGameEngine
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <unordered_set>
-
-#include "body.hpp"
+#include "ecs.hpp"
+#include "task_pool.hpp"
 
 namespace NGameEngine {
 
@@ -11,22 +10,33 @@ class TPhysicsEngine {
     TPhysicsEngine()  = default;
     ~TPhysicsEngine() = default;
 
-    void init(float simulation_step);
+    void init(float simulation_step, TTaskPool* task_pool);
     void deinit();
 
-    void addRigidBody(TRigidBody* rigid_body);
-    void update(float dt);
+    // NOTE: simulates entities with TTransform, TVelocity and TMass, returns
+    // false if not enough time has passed for a step
+    bool update(float dt, TWorld* world);
+
+    // NOTE: seconds, the next step happens once this much time has passed
+    void setSimulationStep(float simulation_step);
+
+  public:
+    // getters
+    float simulationStep() const;
+    // moved by the last step
+    size_t simulatedBodies() const;
 
   private:
-    void simulate(float dt);
+    void simulate(float dt, TWorld* world);
 
-    void moveBodies(float dt);
-    void applyForces(float dt);
+    void moveBodies(float dt, TWorld* world);
+    void applyForces(float dt, TWorld* world);
 
   private:
     float simulation_step_;
     float spent_time_;
-    std::unordered_set<TRigidBody*> bodies_;
+    TTaskPool* task_pool_    = nullptr;
+    size_t simulated_bodies_ = 0;
 };
 
 }  // namespace NGameEngine
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace NGameEngine {
+
+// NOTE: zones of every thread go to its own ring buffer, writing one is two
+// clock reads and a store without locks. The oldest zones are overwritten,
+// an export holds at most kProfileRingSize zones per thread. Zones are only
+// compiled in when the engine is built with GACHIBALL_PROFILING.
+static constexpr size_t kProfileRingSize = 1 << 16;
+
+void SetProfilingEnabled(bool enabled);
+bool ProfilingEnabled();
+
+// NOTE: shown in exported traces, the name must outlive the profiler
+void SetProfileThreadName(const char* name);
+
+// NOTE: Chrome trace event JSON, opens in chrome://tracing and Perfetto.
+// Safe to call while other threads record zones.
+bool ExportChromeTrace(const std::string& path);
+
+// NOTE: the name must outlive the profiler (string literals)
+class TProfileZone {
+  public:
+    explicit TProfileZone(const char* name);
+    ~TProfileZone();
+
+    TProfileZone(const TProfileZone&)            = delete;
+    TProfileZone& operator=(const TProfileZone&) = delete;
+
+  private:
+    const char* name_;
+    // NOTE: 0 if profiling was disabled when the zone was entered
+    uint64_t begin_ns_;
+};
+
+}  // namespace NGameEngine
+
+#ifdef GACHIBALL_PROFILING
+#define GACHIBALL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GACHIBALL_PROFILE_CONCAT(a, b) GACHIBALL_PROFILE_CONCAT_IMPL(a, b)
+#define GACHIBALL_PROFILE_ZONE(name)                      \
+    ::NGameEngine::TProfileZone GACHIBALL_PROFILE_CONCAT( \
+        gachiball_profile_zone_, __LINE__                 \
+    )(name)
+#else
+#define GACHIBALL_PROFILE_ZONE(name) ((void)0)
+#endif
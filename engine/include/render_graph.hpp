@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string_view>
+
+#include "gpu_timer.hpp"
+
+namespace NGameEngine {
+
+using TRenderResource = size_t;
+
+static constexpr TRenderResource kInvalidRenderResource =
+    std::numeric_limits<TRenderResource>::max();
+
+enum class ERenderAccess : size_t {
+    COLOR_ATTACHMENT = 0,
+    DEPTH_ATTACHMENT,
+    SAMPLED,
+    STORAGE,
+    TRANSFER,
+    VERTEX_BUFFER,
+    UNIFORM_BUFFER,
+    RENDER_ACCESS_COUNT,
+};
+
+struct TRenderTextureDesc {
+    int width       = 0;
+    int height      = 0;
+    uint32_t format = 0;
+
+    bool operator==(const TRenderTextureDesc&) const = default;
+};
+
+struct TRenderBufferDesc {
+    size_t size = 0;
+
+    bool operator==(const TRenderBufferDesc&) const = default;
+};
+
+class TRenderGraph;
+
+class TRenderPassBuilder {
+  public:
+    TRenderPassBuilder(TRenderGraph* graph, size_t pass);
+
+    void read(TRenderResource resource, ERenderAccess access);
+    void write(TRenderResource resource, ERenderAccess access);
+
+    // NOTE: pass is never culled, e.g. it writes something outside the graph
+    void markSideEffect();
+
+  private:
+    TRenderGraph* graph_;
+    size_t pass_;
+};
+
+class TRenderPassContext {
+  public:
+    TRenderPassContext(const TRenderGraph* graph, size_t pass);
+
+    // framebuffer with the pass attachments, already bound
+    uint32_t framebuffer() const;
+
+    uint32_t texture(TRenderResource resource) const;
+    uint32_t buffer(TRenderResource resource) const;
+
+    // framebuffer with the texture as the only color attachment, for blits
+    uint32_t readFramebuffer(TRenderResource resource) const;
+
+  private:
+    const TRenderGraph* graph_;
+    size_t pass_;
+};
+
+using TRenderPassSetup   = std::function<void(TRenderPassBuilder&)>;
+using TRenderPassExecute = std::function<void(const TRenderPassContext&)>;
+
+// NOTE: passes are described once, the graph is recompiled only when passes
+// or resource descriptions change. Compilation orders passes by their
+// resource dependencies, culls passes whose results nobody reads, computes
+// memory barriers and lets transient resources with disjoint lifetimes share
+// one GL object.
+class TRenderGraph {
+    class TImpl;
+
+    friend class TRenderPassBuilder;
+    friend class TRenderPassContext;
+
+  public:
+    TRenderGraph();
+    ~TRenderGraph();
+
+    void init(TGpuTimer* gpu_timer);
+    void deinit();
+
+  public:
+    TRenderResource createTexture(
+        std::string_view name, const TRenderTextureDesc& desc
+    );
+    TRenderResource createBuffer(
+        std::string_view name, const TRenderBufferDesc& desc
+    );
+
+    TRenderResource importTexture(
+        std::string_view name, uint32_t texture, const TRenderTextureDesc& desc
+    );
+    TRenderResource importBuffer(
+        std::string_view name, uint32_t buffer, const TRenderBufferDesc& desc
+    );
+    TRenderResource importBackbuffer(std::string_view name);
+
+    // NOTE: output resources keep their writers alive
+    void markOutput(TRenderResource resource);
+
+    void setTextureDesc(
+        TRenderResource resource, const TRenderTextureDesc& desc
+    );
+    void setBufferDesc(TRenderResource resource, const TRenderBufferDesc& desc);
+
+    void addPass(
+        std::string_view name,
+        const TRenderPassSetup& setup,
+        TRenderPassExecute execute
+    );
+
+    void compile();
+    // compiles if needed
+    void execute();
+
+  public:
+    // stats of the last compilation
+    size_t activePassCount() const;
+    size_t culledPassCount() const;
+    size_t physicalTextureCount() const;
+    size_t physicalBufferCount() const;
+
+  private:
+    std::unique_ptr<TImpl> impl_;
+};
+
+}  // namespace NGameEngine
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <limits>
+#include <vector>
+
+namespace NGameEngine {
+
+using TSceneNode = uint32_t;
+
+static constexpr TSceneNode kInvalidSceneNode =
+    std::numeric_limits<TSceneNode>::max();
+
+// NOTE: transform hierarchy with cached local and world matrices. Changing a
+// node marks it dirty and flags its ancestors, update() walks only the
+// flagged paths and recomputes dirty nodes together with their subtrees.
+class TSceneGraph {
+  public:
+    TSceneGraph() = default;
+
+    TSceneNode createNode(TSceneNode parent = kInvalidSceneNode);
+    // NOTE: children of a destroyed node become roots
+    void destroyNode(TSceneNode node);
+
+    void setParent(TSceneNode node, TSceneNode parent);
+    // marks the node dirty only if the transform actually changed
+    void setLocalTransform(
+        TSceneNode node, const glm::vec3& position, const glm::quat& rotation
+    );
+
+    // returns count of recomputed world matrices
+    size_t update();
+
+  public:
+    // getters
+    const glm::mat4& localMatrix(TSceneNode node) const;
+    const glm::mat4& worldMatrix(TSceneNode node) const;
+    size_t nodeCount() const;
+    // heap bytes, reserved capacity included
+    size_t memoryUsage() const;
+
+  private:
+    struct TNode {
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::mat4 local;
+        glm::mat4 world;
+
+        TSceneNode parent;
+        TSceneNode first_child;
+        TSceneNode next_sibling;
+        TSceneNode prev_sibling;
+
+        bool alive;
+        bool dirty;
+        bool child_dirty;
+    };
+
+  private:
+    void link(TSceneNode node, TSceneNode parent);
+    void unlink(TSceneNode node);
+    void markDirty(TSceneNode node);
+    void rebuildLocalMatrices();
+
+  private:
+    std::vector<TNode> nodes_;
+    std::vector<TSceneNode> free_nodes_;
+    TSceneNode first_root_ = kInvalidSceneNode;
+    size_t node_count_     = 0;
+
+    std::vector<TSceneNode> dirty_nodes_;
+
+    // NOTE: kept between updates to avoid allocations
+    std::vector<std::pair<TSceneNode, bool>> stack_;
+    std::vector<glm::vec3> batch_positions_;
+    std::vector<glm::quat> batch_rotations_;
+    std::vector<glm::mat4> batch_locals_;
+};
+
+}  // namespace NGameEngine
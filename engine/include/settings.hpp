@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+#include "asset_loader.hpp"
+#include "dynamic_resolution.hpp"
+#include "frame_pacer.hpp"
+#include "input_engine.hpp"
+#include "introspection_server.hpp"
+#include "memory_tracker.hpp"
+#include "metrics.hpp"
+
+namespace NGameEngine {
+
+struct TIdleSettings {
+    bool enabled = true;
+
+    // NOTE: seconds, the longest the loop blocks waiting for events
+    double unfocused_frame_time = 1. / 15.;
+    double hidden_poll_period   = 0.25;
+};
+
+struct TEngineSettings {
+    float simulation_step = 1.f / 60.f;
+    // NOTE: seconds passed to updates every frame instead of the measured
+    // time, makes runs with a recorded input trace repeatable
+    double fixed_frame_time = 0.;
+    // NOTE: threads for parallel queries, negative picks one less than the
+    // hardware threads, 0 runs everything on the main thread
+    int worker_threads = -1;
+    // NOTE: bytes for transient data of a frame, grows on overflow
+    size_t frame_arena_size = 1 << 20;
+
+    // NOTE: invisible window which is always treated as active, for tools
+    // which drive the main loop. A display is still required.
+    bool headless = false;
+    // NOTE: run() returns after this many frames, 0 runs until the window
+    // is closed
+    size_t frame_limit = 0;
+
+    // NOTE: written by TGameEngine::exportProfile
+    std::string profile_path = "gachiball_trace.json";
+
+    TDynamicResolutionSettings dynamic_resolution;
+    TFramePacerSettings frame_pacing;
+    TInputSettings input;
+    TIdleSettings idle;
+    TMetricsSettings metrics;
+    TIntrospectionSettings introspection;
+    TMemoryBudgetSettings memory_budgets;
+    TAssetLoaderSettings assets;
+};
+
+}  // namespace NGameEngine
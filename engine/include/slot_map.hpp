@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace NGameEngine {
+
+// NOTE: the generation changes every time a slot is released, so handles to
+// removed values are detected instead of aliasing the next occupant
+struct TSlotHandle {
+    uint32_t index      = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    bool operator==(const TSlotHandle&) const = default;
+};
+
+// NOTE: values are densely packed in insertion order, removal moves the last
+// value into the hole. Handles address slots which track where their value
+// currently is. Pointers and dense indices are invalidated by insert and
+// erase, handles are not.
+template <typename T>
+class TSlotMap {
+  public:
+    TSlotMap() = default;
+
+    TSlotHandle insert(T value) {
+        uint32_t index;
+        if (!free_slots_.empty()) {
+            index = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(TSlot{});
+        }
+
+        slots_[index].dense = static_cast<uint32_t>(values_.size());
+        values_.push_back(std::move(value));
+        dense_to_slot_.push_back(index);
+        return TSlotHandle{index, slots_[index].generation};
+    }
+
+    // returns false for stale handles
+    bool erase(TSlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        auto dense = slots_[handle.index].dense;
+        auto last  = static_cast<uint32_t>(values_.size() - 1);
+        if (dense != last) {
+            values_[dense]                      = std::move(values_[last]);
+            dense_to_slot_[dense]               = dense_to_slot_[last];
+            slots_[dense_to_slot_[dense]].dense = dense;
+        }
+        values_.pop_back();
+        dense_to_slot_.pop_back();
+
+        auto& slot = slots_[handle.index];
+        slot.dense = kFreeSlot;
+        ++slot.generation;
+        free_slots_.push_back(handle.index);
+        return true;
+    }
+
+    void clear() {
+        for (auto index : dense_to_slot_) {
+            slots_[index].dense = kFreeSlot;
+            ++slots_[index].generation;
+            free_slots_.push_back(index);
+        }
+        values_.clear();
+        dense_to_slot_.clear();
+    }
+
+    bool contains(TSlotHandle handle) const {
+        return handle.index < slots_.size() &&
+               slots_[handle.index].dense != kFreeSlot &&
+               slots_[handle.index].generation == handle.generation;
+    }
+
+    // returns nullptr for stale handles
+    T* get(TSlotHandle handle) {
+        return contains(handle) ? &values_[slots_[handle.index].dense]
+                                : nullptr;
+    }
+
+    const T* get(TSlotHandle handle) const {
+        return contains(handle) ? &values_[slots_[handle.index].dense]
+                                : nullptr;
+    }
+
+    // NOTE: position in values(), lets owners keep parallel arrays in step
+    // by mirroring the swap in erase
+    size_t indexOf(TSlotHandle handle) const {
+        assert(contains(handle));
+        return slots_[handle.index].dense;
+    }
+
+    TSlotHandle handleAt(size_t dense) const {
+        assert(dense < values_.size());
+        auto index = dense_to_slot_[dense];
+        return TSlotHandle{index, slots_[index].generation};
+    }
+
+  public:
+    // getters
+    std::span<T> values() {
+        return values_;
+    }
+
+    std::span<const T> values() const {
+        return values_;
+    }
+
+    size_t size() const {
+        return values_.size();
+    }
+
+    // heap bytes, reserved capacity included
+    size_t memoryUsage() const {
+        return values_.capacity() * sizeof(T) +
+               dense_to_slot_.capacity() * sizeof(uint32_t) +
+               slots_.capacity() * sizeof(TSlot) +
+               free_slots_.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    static constexpr uint32_t kFreeSlot = std::numeric_limits<uint32_t>::max();
+
+    struct TSlot {
+        uint32_t dense      = kFreeSlot;
+        uint32_t generation = 0;
+    };
+
+  private:
+    std::vector<T> values_;
+    std::vector<uint32_t> dense_to_slot_;
+    std::vector<TSlot> slots_;
+    std::vector<uint32_t> free_slots_;
+};
+
+}  // namespace NGameEngine
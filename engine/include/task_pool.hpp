@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace NGameEngine {
+
+// NOTE: fixed set of worker threads for data parallel loops. Workers sleep
+// between jobs, a job hands out indices through an atomic counter and the
+// calling thread takes part, so a pool without workers runs jobs inline.
+class TTaskPool {
+  public:
+    TTaskPool() = default;
+    ~TTaskPool();
+
+    TTaskPool(const TTaskPool&)            = delete;
+    TTaskPool& operator=(const TTaskPool&) = delete;
+
+    // NOTE: negative count picks one worker less than hardware threads
+    void init(int worker_count = -1);
+    void deinit();
+
+    // NOTE: runs func(i) for every i in [0, count) and blocks until all of
+    // them are done. The calls run concurrently, func must be thread safe.
+    // One job at a time, call from a single thread.
+    template <typename TFunc>
+    void parallelFor(size_t count, TFunc&& func) {
+        using TCallable = std::remove_reference_t<TFunc>;
+        run(
+            count,
+            [](void* context, size_t index) {
+                (*static_cast<TCallable*>(context))(index);
+            },
+            const_cast<void*>(static_cast<const void*>(&func))
+        );
+    }
+
+  public:
+    // getters
+    size_t workerCount() const;
+
+  private:
+    using TJobFunc = void (*)(void* context, size_t index);
+
+    void run(size_t count, TJobFunc func, void* context);
+    void work();
+    void workerLoop();
+
+  private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable job_done_;
+    uint64_t job_        = 0;
+    size_t busy_workers_ = 0;
+    bool stop_           = false;
+
+    TJobFunc func_ = nullptr;
+    void* context_ = nullptr;
+    size_t count_  = 0;
+    std::atomic<size_t> next_index_{0};
+};
+
+}  // namespace NGameEngine
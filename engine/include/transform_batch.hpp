@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace NGameEngine {
+
+// NOTE: batched transform kernels, SSE processes 4 and AVX2 (when the engine
+// is built with GACHIBALL_ENABLE_AVX2) 8 bodies per iteration, the tail and
+// other targets use the scalar path. Input and output arrays may be
+// unaligned but must not overlap.
+
+// models[i] = translate(positions[i]) * mat4_cast(rotations[i])
+void BuildModelMatrices(
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models
+);
+
+// same as above, plus mvps[i] = vp * models[i]
+void BuildModelMvpMatrices(
+    const glm::mat4& vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+);
+
+// out[i] = lhs * rhs[i]
+void MultiplyMatrices(
+    const glm::mat4& lhs, const glm::mat4* rhs, size_t count, glm::mat4* out
+);
+
+// NOTE: name of the compiled in path, for logs and benchmarks
+const char* TransformBatchBackend();
+
+}  // namespace NGameEngine
@@ -17,7 +17,17 @@ class TWindow {
     ~TWindow();
 
   public:
-    static std::unique_ptr<TWindow> MakeGLFWWindow();
+    // NOTE: an invisible window still has a context and a backbuffer
+    static std::unique_ptr<TWindow> MakeGLFWWindow(bool visible = true);
+
+    // NOTE: hidden window whose context shares objects with this one, for
+    // threads which create GL resources. Main thread only, like any window
+    // creation, returns nullptr on failure.
+    std::unique_ptr<TWindow> makeSharedContext();
+
+    // NOTE: detaches the context current on the calling thread, a context
+    // must be released before another thread binds it
+    static void ReleaseCurrentContext();
 
   public:
     // getters
@@ -27,6 +37,10 @@ class TWindow {
 
     std::pair<double, double> cursor_position() const;
 
+    bool focused() const;
+    // NOTE: minimized or hidden, nothing drawn to the window can be seen
+    bool hidden() const;
+
   public:
     bool shouldClose();
 
@@ -36,6 +50,10 @@ class TWindow {
     void grabCursor();
     void ungrabCursor();
 
+    // NOTE: unaccelerated motion while the cursor is grabbed, returns false
+    // if the platform does not support it
+    bool enableRawMouseMotion();
+
     void registerKeyboardKeyCallback(TKeyboardKeyCallback callback);
     void registerMouseKeyCallback(TMouseKeyCallback callback);
     void registerCursorPositionCallback(TCursorPositionCallback callback);
@@ -0,0 +1,196 @@
+#include "action_map.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+
+namespace NGameEngine {
+
+namespace {
+
+std::optional<EInputDevice> ParseDevice(std::string_view name) {
+    if (name == "keyboard") {
+        return EInputDevice::KEYBOARD;
+    }
+    if (name == "mouse") {
+        return EInputDevice::MOUSE;
+    }
+    return std::nullopt;
+}
+
+std::optional<EKey> ParseKey(EInputDevice device, std::string_view name) {
+    if (device == EInputDevice::MOUSE) {
+        if (name == "LEFT") {
+            return EKey::MOUSE_LEFT;
+        }
+        if (name == "RIGHT") {
+            return EKey::MOUSE_RIGHT;
+        }
+        if (name == "MIDDLE") {
+            return EKey::MOUSE_MIDDLE;
+        }
+        return std::nullopt;
+    }
+
+    if (name == "SPACE") {
+        return EKey::KEY_SPACE;
+    }
+    if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z') {
+        // NOTE: KEY_A..KEY_Z are contiguous
+        return static_cast<EKey>(
+            static_cast<size_t>(EKey::KEY_A) + (name[0] - 'A')
+        );
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+TActionMap::TActionMap() {
+}
+
+bool TActionMap::load(const std::string& path) {
+    std::ifstream in{path};
+    if (!in) {
+        std::cerr << "Failed to open bindings " << path << std::endl;
+        return false;
+    }
+    return parse(in, path);
+}
+
+bool TActionMap::parse(std::istream& in, std::string_view source) {
+    decltype(bindings_) bindings{};
+    std::vector<std::string> names;
+
+    auto fail = [&source](size_t line_number, std::string_view message) {
+        std::cerr << source << ":" << line_number << ": " << message
+                  << std::endl;
+        return false;
+    };
+
+    std::string line;
+    for (size_t line_number = 1; std::getline(in, line); ++line_number) {
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields{line};
+        std::string action_name, device_name, key_name;
+        if (!(fields >> action_name)) {
+            continue;
+        }
+        if (!(fields >> device_name >> key_name)) {
+            return fail(line_number, "expected <action> <device> <key>");
+        }
+
+        float scale = 1.f;
+        if (!(fields >> scale)) {
+            if (!fields.eof()) {
+                return fail(line_number, "scale is not a number");
+            }
+            scale = 1.f;
+        }
+
+        auto device = ParseDevice(device_name);
+        if (!device) {
+            return fail(line_number, "unknown device " + device_name);
+        }
+        auto key = ParseKey(*device, key_name);
+        if (!key) {
+            return fail(line_number, "unknown key " + key_name);
+        }
+
+        auto it = std::find(names.begin(), names.end(), action_name);
+        if (it == names.end()) {
+            if (names.size() == kInvalidAction) {
+                return fail(line_number, "too many actions");
+            }
+            it = names.insert(names.end(), action_name);
+        }
+
+        auto& binding = bindings[static_cast<size_t>(*device) * kKeyCount +
+                                 static_cast<size_t>(*key)];
+        if (binding.action != kInvalidAction) {
+            return fail(line_number, "key is already bound");
+        }
+        binding.action = static_cast<TActionId>(it - names.begin());
+        binding.scale  = scale;
+    }
+
+    bindings_ = bindings;
+    names_    = std::move(names);
+    states_.assign(names_.size(), TActionState{});
+    for (size_t i = 0; i < keys_down_.size(); ++i) {
+        if (keys_down_[i] && bindings_[i].action != kInvalidAction) {
+            auto& state = states_[bindings_[i].action];
+            state.value += bindings_[i].scale;
+            ++state.held_keys;
+        }
+    }
+    return true;
+}
+
+void TActionMap::onInputEvent(const TInputEvent& event) {
+    auto index = static_cast<size_t>(event.type.input_device) * kKeyCount +
+                 static_cast<size_t>(event.type.key);
+    auto action = event.type.key_action;
+    if (index >= keys_down_.size() ||
+        (action != EKeyAction::PRESSED && action != EKeyAction::RELEASED)) {
+        return;
+    }
+
+    // NOTE: a key released without a press, e.g. held since before the
+    // window got focus, would leave the value off by its scale
+    auto down = action == EKeyAction::PRESSED;
+    if (keys_down_[index] == down) {
+        return;
+    }
+    keys_down_[index] = down;
+
+    const auto& binding = bindings_[index];
+    if (binding.action == kInvalidAction) {
+        return;
+    }
+
+    auto& state = states_[binding.action];
+    if (down) {
+        state.value += binding.scale;
+        state.pressed |= ++state.held_keys == 1;
+    } else {
+        state.value -= binding.scale;
+        state.released |= --state.held_keys == 0;
+    }
+}
+
+void TActionMap::clearEdges() {
+    for (auto& state : states_) {
+        state.pressed  = false;
+        state.released = false;
+    }
+}
+
+TActionId TActionMap::action(std::string_view name) const {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    if (it == names_.end()) {
+        return kInvalidAction;
+    }
+    return static_cast<TActionId>(it - names_.begin());
+}
+
+float TActionMap::value(TActionId action) const {
+    return action < states_.size() ? states_[action].value : 0.f;
+}
+
+bool TActionMap::held(TActionId action) const {
+    return action < states_.size() && states_[action].held_keys > 0;
+}
+
+bool TActionMap::pressed(TActionId action) const {
+    return action < states_.size() && states_[action].pressed;
+}
+
+bool TActionMap::released(TActionId action) const {
+    return action < states_.size() && states_[action].released;
+}
+
+}  // namespace NGameEngine
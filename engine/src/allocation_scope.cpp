@@ -0,0 +1,19 @@
+#include "allocation_scope.hpp"
+
+namespace NGameEngine {
+
+namespace {
+
+thread_local const char* current_scope = nullptr;
+
+}  // namespace
+
+void SetAllocationScope(const char* name) {
+    current_scope = name;
+}
+
+const char* CurrentAllocationScope() {
+    return current_scope;
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,270 @@
+#include "asset_loader.hpp"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <iterator>
+
+#include "profiler.hpp"
+
+namespace NGameEngine {
+
+struct TMeshRequest {
+    TMeshDecoder decoder;
+    // NOTE: set by the mesh handed out when it is destroyed, the load is
+    // dropped at the next stage
+    std::atomic<bool> abandoned{false};
+
+    // NOTE: each field is written by one stage and read by the next, the
+    // queues under the loader mutex order them
+    std::optional<TMeshSource> source;
+    TMeshBuffers buffers;
+    GLsync fence = nullptr;
+
+    // NOTE: main thread only
+    std::unique_ptr<IMesh> mesh;
+};
+
+namespace {
+
+// NOTE: forwards to the loaded mesh, the request keeps it
+class TLoadingMesh : public IMesh {
+  public:
+    TLoadingMesh(std::shared_ptr<TMeshRequest> request);
+    ~TLoadingMesh() override;
+
+    void draw(const glm::mat4& mvp) override;
+
+  public:
+    // getters
+    size_t triangleCount() const override;
+
+  private:
+    std::shared_ptr<TMeshRequest> request_;
+};
+
+TLoadingMesh::TLoadingMesh(std::shared_ptr<TMeshRequest> request)
+    : request_(std::move(request)) {
+}
+
+TLoadingMesh::~TLoadingMesh() {
+    request_->abandoned.store(true, std::memory_order_relaxed);
+}
+
+void TLoadingMesh::draw(const glm::mat4& mvp) {
+    if (request_->mesh) {
+        request_->mesh->draw(mvp);
+    }
+}
+
+size_t TLoadingMesh::triangleCount() const {
+    return request_->mesh ? request_->mesh->triangleCount() : 0;
+}
+
+void DeleteMeshBuffers(const TMeshBuffers& buffers) {
+    std::array<GLuint, 2> names{buffers.vertex_buffer, buffers.index_buffer};
+    glDeleteBuffers(names.size(), names.data());
+    glDeleteProgram(buffers.shader_program);
+}
+
+}  // namespace
+
+TAssetLoader::~TAssetLoader() {
+    deinit();
+}
+
+void TAssetLoader::init(TWindow* window, const TAssetLoaderSettings& settings) {
+    if (settings.upload_context) {
+        upload_context_ = window->makeSharedContext();
+    }
+    if (upload_context_) {
+        upload_thread_ = std::thread{&TAssetLoader::uploadLoop, this};
+    } else {
+        std::cerr << "Assets are uploaded on the main thread" << std::endl;
+    }
+
+    for (int i = 0; i < std::max(settings.io_threads, 1); ++i) {
+        io_threads_.emplace_back(&TAssetLoader::ioLoop, this);
+    }
+}
+
+void TAssetLoader::deinit() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    decode_ready_.notify_all();
+    upload_ready_.notify_all();
+
+    for (auto& thread : io_threads_) {
+        thread.join();
+    }
+    io_threads_.clear();
+    if (upload_thread_.joinable()) {
+        upload_thread_.join();
+    }
+    // NOTE: windows are destroyed on the main thread
+    upload_context_.reset();
+
+    // NOTE: the main context is still current and shares the uploads
+    fenced_.insert(fenced_.end(), uploaded_.begin(), uploaded_.end());
+    for (const auto& request : fenced_) {
+        glDeleteSync(request->fence);
+        DeleteMeshBuffers(request->buffers);
+    }
+    fenced_.clear();
+    uploaded_.clear();
+    decode_queue_.clear();
+    upload_queue_.clear();
+    pending_ = 0;
+    stop_    = false;
+}
+
+std::unique_ptr<IMesh> TAssetLoader::loadMesh(std::string path) {
+    return loadMesh([path = std::move(path)]() {
+        // NOTE: the file is read here rather than on first access by the
+        // upload
+        return ReadMeshFile(path, true);
+    });
+}
+
+std::unique_ptr<IMesh> TAssetLoader::loadMesh(TMeshDecoder decoder) {
+    auto request     = std::make_shared<TMeshRequest>();
+    request->decoder = std::move(decoder);
+    auto mesh        = std::make_unique<TLoadingMesh>(request);
+
+    ++pending_;
+    {
+        std::lock_guard lock{mutex_};
+        decode_queue_.push_back(std::move(request));
+    }
+    decode_ready_.notify_one();
+    return mesh;
+}
+
+void TAssetLoader::update() {
+    GACHIBALL_PROFILE_ZONE("asset update");
+    TRequestPtr inline_upload;
+    if (std::unique_lock lock{mutex_, std::try_to_lock}; lock.owns_lock()) {
+        fenced_.insert(
+            fenced_.end(),
+            std::make_move_iterator(uploaded_.begin()),
+            std::make_move_iterator(uploaded_.end())
+        );
+        uploaded_.clear();
+
+        if (!upload_thread_.joinable() && !upload_queue_.empty()) {
+            inline_upload = std::move(upload_queue_.front());
+            upload_queue_.pop_front();
+        }
+    }
+
+    if (inline_upload && inline_upload->abandoned) {
+        --pending_;
+    } else if (inline_upload) {
+        upload(*inline_upload);
+        fenced_.push_back(std::move(inline_upload));
+    }
+
+    std::erase_if(fenced_, [this](const TRequestPtr& request) {
+        return finish(*request);
+    });
+}
+
+void TAssetLoader::ioLoop() {
+    SetProfileThreadName("asset io");
+    for (;;) {
+        TRequestPtr request;
+        {
+            std::unique_lock lock{mutex_};
+            decode_ready_.wait(lock, [this] {
+                return stop_ || !decode_queue_.empty();
+            });
+            if (stop_) {
+                return;
+            }
+            request = std::move(decode_queue_.front());
+            decode_queue_.pop_front();
+        }
+
+        if (!request->abandoned) {
+            GACHIBALL_PROFILE_ZONE("asset decode");
+            request->source = request->decoder();
+        }
+        if (!request->source) {
+            --pending_;
+            continue;
+        }
+
+        {
+            std::lock_guard lock{mutex_};
+            upload_queue_.push_back(std::move(request));
+        }
+        upload_ready_.notify_one();
+    }
+}
+
+void TAssetLoader::uploadLoop() {
+    SetProfileThreadName("asset upload");
+    // NOTE: GL entry points loaded by glad for the main context serve every
+    // context of its share group
+    upload_context_->bindCurrentContext();
+    for (;;) {
+        TRequestPtr request;
+        {
+            std::unique_lock lock{mutex_};
+            upload_ready_.wait(lock, [this] {
+                return stop_ || !upload_queue_.empty();
+            });
+            if (stop_) {
+                break;
+            }
+            request = std::move(upload_queue_.front());
+            upload_queue_.pop_front();
+        }
+
+        if (request->abandoned) {
+            --pending_;
+            continue;
+        }
+        upload(*request);
+
+        std::lock_guard lock{mutex_};
+        uploaded_.push_back(std::move(request));
+    }
+    TWindow::ReleaseCurrentContext();
+}
+
+void TAssetLoader::upload(TMeshRequest& request) {
+    request.buffers = UploadMeshSource(*request.source);
+    // NOTE: GL has copied the data, a mapped file is unmapped here
+    request.source.reset();
+
+    request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // NOTE: other contexts only see a fence once it is flushed
+    glFlush();
+}
+
+bool TAssetLoader::finish(TMeshRequest& request) {
+    if (glClientWaitSync(request.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    glDeleteSync(request.fence);
+    request.fence = nullptr;
+
+    if (request.abandoned) {
+        DeleteMeshBuffers(request.buffers);
+    } else {
+        request.mesh = CreateMesh(request.buffers);
+    }
+    --pending_;
+    return true;
+}
+
+size_t TAssetLoader::pendingCount() const {
+    return pending_.load(std::memory_order_relaxed);
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,73 @@
+#include "dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace NGameEngine {
+
+// NOTE: frame time is smoothed to ignore single spikes
+static constexpr double kSmoothingFactor = 0.1;
+// NOTE: keep some headroom below the budget so we never touch it
+static constexpr double kDownscaleThreshold = 0.95;
+static constexpr double kUpscaleThreshold   = 0.75;
+static constexpr float kMaxScaleStep        = 0.1f;
+static constexpr float kUpscaleStep         = 0.02f;
+// NOTE: GPU timings arrive a few frames late, wait for them to settle
+static constexpr int kAdjustmentCooldown = 8;
+
+void TDynamicResolution::init(const TDynamicResolutionSettings& settings) {
+    assert(settings.min_scale > 0.f);
+    assert(settings.min_scale <= settings.max_scale);
+
+    settings_                = settings;
+    scale_                   = settings_.max_scale;
+    smoothed_frame_time_     = 0.;
+    frames_since_adjustment_ = 0;
+}
+
+void TDynamicResolution::update(double frame_time_ms) {
+    if (!settings_.enabled || frame_time_ms <= 0.) {
+        return;
+    }
+
+    if (smoothed_frame_time_ == 0.) {
+        smoothed_frame_time_ = frame_time_ms;
+    }
+    smoothed_frame_time_ +=
+        kSmoothingFactor * (frame_time_ms - smoothed_frame_time_);
+
+    if (++frames_since_adjustment_ < kAdjustmentCooldown) {
+        return;
+    }
+
+    auto budget    = settings_.target_frame_time_ms;
+    auto new_scale = scale_;
+    if (smoothed_frame_time_ > kDownscaleThreshold * budget) {
+        // NOTE: fill cost is proportional to pixel count, i.e. scale^2
+        auto ratio = std::sqrt(
+            kDownscaleThreshold * budget / smoothed_frame_time_
+        );
+        new_scale = std::max(
+            scale_ * static_cast<float>(ratio), scale_ - kMaxScaleStep
+        );
+    } else if (smoothed_frame_time_ < kUpscaleThreshold * budget) {
+        new_scale = scale_ + kUpscaleStep;
+    }
+
+    new_scale = std::clamp(new_scale, settings_.min_scale, settings_.max_scale);
+    if (new_scale != scale_) {
+        scale_                   = new_scale;
+        frames_since_adjustment_ = 0;
+    }
+}
+
+bool TDynamicResolution::enabled() const {
+    return settings_.enabled;
+}
+
+float TDynamicResolution::scale() const {
+    return settings_.enabled ? scale_ : 1.f;
+}
+
+}  // namespace NGameEngine
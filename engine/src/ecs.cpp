@@ -0,0 +1,197 @@
+#include "ecs.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#include "memory_tracker.hpp"
+
+namespace NGameEngine {
+
+namespace {
+
+struct TComponentRegistry {
+    std::mutex mutex;
+    std::vector<size_t> sizes;
+};
+
+TComponentRegistry& Registry() {
+    static TComponentRegistry registry;
+    return registry;
+}
+
+}  // namespace
+
+TComponentId RegisterComponent(size_t size) {
+    auto& registry = Registry();
+    std::lock_guard lock{registry.mutex};
+    if (registry.sizes.size() == kMaxComponentTypes) {
+        std::cerr << "Too many component types, at most "
+                  << kMaxComponentTypes << " are supported" << std::endl;
+        std::exit(9);
+    }
+
+    registry.sizes.push_back(size);
+    return static_cast<TComponentId>(registry.sizes.size() - 1);
+}
+
+size_t ComponentSize(TComponentId component) {
+    auto& registry = Registry();
+    std::lock_guard lock{registry.mutex};
+    assert(component < registry.sizes.size());
+    return registry.sizes[component];
+}
+
+TEntity TWorld::createEntity(TComponentMask mask) {
+    auto archetype = findOrCreateArchetype(mask);
+    auto entity    = locations_.insert(TLocation{archetype, 0});
+
+    locations_.get(entity)->row = pushRow(archetype, entity);
+    return entity;
+}
+
+void TWorld::destroy(TEntity entity) {
+    if (auto* location = locations_.get(entity)) {
+        removeRow(location->archetype, location->row);
+        locations_.erase(entity);
+    }
+}
+
+bool TWorld::alive(TEntity entity) const {
+    return locations_.contains(entity);
+}
+
+TComponentMask TWorld::mask(TEntity entity) const {
+    return archetypes_[locations_.get(entity)->archetype].mask;
+}
+
+void TWorld::setMask(TEntity entity, TComponentMask mask) {
+    auto from = *locations_.get(entity);
+    if (archetypes_[from.archetype].mask == mask) {
+        return;
+    }
+
+    // NOTE: may grow archetypes_, references are taken afterwards
+    auto archetype = findOrCreateArchetype(mask);
+    auto row       = pushRow(archetype, entity);
+
+    auto& src = archetypes_[from.archetype];
+    auto& dst = archetypes_[archetype];
+    for (const auto& column : src.columns) {
+        auto index = dst.column_index[column.component];
+        if (index < 0) {
+            continue;
+        }
+        std::memcpy(
+            dst.columns[index].data.data() + row * column.stride,
+            column.data.data() + from.row * column.stride,
+            column.stride
+        );
+    }
+
+    removeRow(from.archetype, from.row);
+    *locations_.get(entity) = TLocation{archetype, row};
+}
+
+void* TWorld::componentData(TEntity entity, TComponentId component) {
+    auto* location = locations_.get(entity);
+    if (!location) {
+        return nullptr;
+    }
+
+    auto& archetype = archetypes_[location->archetype];
+    auto index      = archetype.column_index[component];
+    if (index < 0) {
+        return nullptr;
+    }
+
+    auto& column = archetype.columns[index];
+    return column.data.data() + location->row * column.stride;
+}
+
+uint32_t TWorld::findOrCreateArchetype(TComponentMask mask) {
+    if (auto it = archetype_by_mask_.find(mask);
+        it != archetype_by_mask_.end()) {
+        return it->second;
+    }
+
+    TArchetype archetype;
+    archetype.mask = mask;
+    archetype.column_index.fill(-1);
+    for (TComponentId component = 0; component < kMaxComponentTypes;
+         ++component) {
+        if (mask & (TComponentMask{1} << component)) {
+            archetype.column_index[component] =
+                static_cast<int8_t>(archetype.columns.size());
+            archetype.columns.push_back(TArchetype::TColumn{
+                .component = component,
+                .stride    = ComponentSize(component),
+                .data      = {},
+            });
+        }
+    }
+
+    auto index = static_cast<uint32_t>(archetypes_.size());
+    archetypes_.push_back(std::move(archetype));
+    archetype_by_mask_.emplace(mask, index);
+    return index;
+}
+
+uint32_t TWorld::pushRow(uint32_t archetype, TEntity entity) {
+    auto& table = archetypes_[archetype];
+    auto row    = static_cast<uint32_t>(table.entities.size());
+
+    table.entities.push_back(entity);
+    for (auto& column : table.columns) {
+        column.data.resize(column.data.size() + column.stride);
+    }
+    return row;
+}
+
+void TWorld::removeRow(uint32_t archetype, uint32_t row) {
+    auto& table = archetypes_[archetype];
+    auto last   = static_cast<uint32_t>(table.entities.size() - 1);
+
+    if (row != last) {
+        for (auto& column : table.columns) {
+            std::memcpy(
+                column.data.data() + row * column.stride,
+                column.data.data() + last * column.stride,
+                column.stride
+            );
+        }
+        table.entities[row]                      = table.entities[last];
+        locations_.get(table.entities[row])->row = row;
+    }
+
+    table.entities.pop_back();
+    for (auto& column : table.columns) {
+        column.data.resize(column.data.size() - column.stride);
+    }
+}
+
+size_t TWorld::entityCount() const {
+    return locations_.size();
+}
+
+size_t TWorld::archetypeCount() const {
+    return archetypes_.size();
+}
+
+size_t TWorld::memoryUsage() const {
+    auto bytes = CapacityBytes(archetypes_) + CapacityBytes(chunks_) +
+                 locations_.memoryUsage();
+    for (const auto& archetype : archetypes_) {
+        bytes += CapacityBytes(archetype.entities) +
+                 CapacityBytes(archetype.columns);
+        for (const auto& column : archetype.columns) {
+            bytes += CapacityBytes(column.data);
+        }
+    }
+    // NOTE: node based map, counted by its elements
+    bytes += archetype_by_mask_.size() *
+             (sizeof(TComponentMask) + sizeof(uint32_t) + 2 * sizeof(void*));
+    return bytes;
+}
+
+}  // namespace NGameEngine
@@ -5,60 +5,170 @@
 #include <GLFW/glfw3.h>
 // clang-format on
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
-#include <unordered_set>
 
+#include "allocation_scope.hpp"
+#include "asset_loader.hpp"
+#include "components.hpp"
+#include "ecs.hpp"
 #include "event_dispatcher.hpp"
+#include "frame_arena.hpp"
+#include "frame_pacer.hpp"
+#include "gpu_timer.hpp"
 #include "input_engine.hpp"
+#include "introspection_server.hpp"
+#include "latency_tracker.hpp"
+#include "memory_tracker.hpp"
 #include "mesh.hpp"
+#include "metrics.hpp"
 #include "physics_engine.hpp"
+#include "profiler.hpp"
+#include "render_graph.hpp"
+#include "scene_graph.hpp"
+#include "task_pool.hpp"
+#include "transform_batch.hpp"
 #include "window.hpp"
 
 namespace NGameEngine {
 
+static constexpr double kGpuTimingsReportPeriod = 5.;
+
+// NOTE: node of a body in the scene graph, engine internal component
+struct TSceneNodeRef {
+    TSceneNode node;
+};
+
+enum class EWindowActivity {
+    ACTIVE = 0,
+    // NOTE: visible in the background, rendered and simulated at a low rate
+    UNFOCUSED,
+    // NOTE: nothing can be seen, neither rendered nor simulated
+    HIDDEN,
+    WINDOW_ACTIVITY_COUNT,
+};
+
 class TGameEngineImpl {
   public:
     TGameEngineImpl() = default;
 
-    void init();
+    void init(TEngineSettings settings);
     void deinit();
     void run(IGame *game);
 
     void bindCamera(const ICamera *camera);
 
-    void addBody(TBody *body);
-    void addBody(TRigidBody *body);
-    void removeBody(TBody *body);
+    TEntity addBody(const TTransform &transform, TEntity parent);
+    void removeBody(TEntity entity);
+    TWorld &world();
+
+    std::unique_ptr<IMesh> loadMesh(std::string path);
+    std::unique_ptr<IMesh> loadMesh(TMeshDecoder decoder);
+    size_t pendingAssetCount() const;
 
-    void registerInputCallback(
+    void grabCursor();
+    void ungrabCursor();
+
+    bool loadActionMap(const std::string &path);
+    const TActionMap &actions() const;
+
+    TEventSubscription registerInputCallback(
         TInputEventType event_type, TInputCallback callback
     );
+    void unregisterInputCallback(TEventSubscription subscription);
     void unregisterInputCallback(TInputEventType event_type);
 
+    std::span<const TMouseMotionSample> mouseMotionSamples() const;
+
+    TEventBus &eventBus();
+    const std::vector<TGpuPassTiming> &gpuTimings() const;
+    bool exportProfile();
+
   public:
     // NOTE: Various callbacks
     void frameBufferSizeCallback(GLFWwindow *window, int width, int height);
 
   private:
+    EWindowActivity windowActivity() const;
+    // NOTE: blocks until deadline on the glfwGetTime clock, input arriving
+    // meanwhile is queued and handled at the end. Returns the number of
+    // dispatched input events.
+    size_t pollInput(double deadline = 0.);
+
+    void initRenderGraph();
+    void initIntrospection();
+    bool writeStats(std::ostream &out);
+    bool setTunable(std::string_view name, double value);
+    // NOTE: CPU usage of engine owned containers, GPU usage is tracked at
+    // allocation
+    void sampleMemoryUsage();
+    void prepareFrame(int width, int height);
+    void buildDrawList();
+
+    void drawScene();
+    void upscaleScene(const TRenderPassContext &context);
+
+  private:
+    TEngineSettings settings_;
+
     std::unique_ptr<TWindow> window_;
 
+    TTaskPool task_pool_;
+    TAssetLoader asset_loader_;
+
     TInputEngine input_engine_;
     TEventDispatcher event_dispatcher_;
+    TEventBus event_bus_;
+    TActionMap action_map_;
     TPhysicsEngine physics_engine_;
-
-    std::unordered_set<TBody *> bodies_;
+    TGpuTimer gpu_timer_;
+    TLatencyTracker latency_tracker_;
+    TMetrics metrics_;
+    TIntrospectionServer introspection_;
+
+    TDynamicResolution dynamic_resolution_;
+    TFramePacer frame_pacer_;
+    TFrameArena frame_arena_;
+
+    TRenderGraph render_graph_;
+    TRenderResource backbuffer_  = kInvalidRenderResource;
+    TRenderResource scene_color_ = kInvalidRenderResource;
+    TRenderResource scene_depth_ = kInvalidRenderResource;
+
+    // NOTE: per frame state read by render passes
+    struct {
+        int width        = 0;
+        int height       = 0;
+        int scene_width  = 0;
+        int scene_height = 0;
+        glm::mat4 projection;
+        glm::mat4 vp;
+    } frame_;
+
+    TWorld world_;
+    TSceneGraph scene_graph_;
+
+    // NOTE: rebuilt every frame in the frame arena
+    std::span<IMesh *> draw_meshes_;
+    std::span<glm::mat4> draw_models_;
+    std::span<glm::mat4> draw_mvps_;
     const ICamera *camera_;
 };
 
-void TGameEngineImpl::init() {
+void TGameEngineImpl::init(TEngineSettings settings) {
+    settings_ = std::move(settings);
+    SetProfileThreadName("main");
+    SetMemoryBudgets(settings_.memory_budgets);
+
     if (!glfwInit()) {
         std::cerr << "Failed to initialize glfw" << std::endl;
         std::exit(1);
     }
 
-    window_ = TWindow::MakeGLFWWindow();
+    window_ = TWindow::MakeGLFWWindow(!settings_.headless);
     if (!window_) {
         std::cerr << "Failed to create window" << std::endl;
     }
@@ -69,92 +179,570 @@ void TGameEngineImpl::init() {
         std::exit(5);
     }
 
-    input_engine_.init(window_.get(), &event_dispatcher_);
-    physics_engine_.init(1.f / 60.f);
+    task_pool_.init(settings_.worker_threads);
+    asset_loader_.init(window_.get(), settings_.assets);
+    frame_pacer_.init(settings_.frame_pacing);
+    frame_arena_.init(settings_.frame_arena_size);
+    input_engine_.init(window_.get(), &event_dispatcher_, settings_.input);
+    physics_engine_.init(settings_.simulation_step, &task_pool_);
+    gpu_timer_.init();
+    latency_tracker_.init();
+    metrics_.init(settings_.metrics, glfwGetTime());
+    introspection_.init(settings_.introspection);
+    initIntrospection();
+    event_dispatcher_.setInputObserver([this](const TInputEvent &event) {
+        latency_tracker_.onInputEvent(event);
+        action_map_.onInputEvent(event);
+    });
+    dynamic_resolution_.init(settings_.dynamic_resolution);
+    render_graph_.init(&gpu_timer_);
+    initRenderGraph();
 }
 
 void TGameEngineImpl::deinit() {
+    render_graph_.deinit();
+    introspection_.deinit();
+    metrics_.deinit();
+    latency_tracker_.deinit();
+    gpu_timer_.deinit();
+    asset_loader_.deinit();
     window_.reset();
     physics_engine_.deinit();
+    task_pool_.deinit();
+    frame_arena_.deinit();
     glfwTerminate();
 }
 
 void TGameEngineImpl::run(IGame *game) {
     glEnable(GL_DEPTH_TEST);
     game->init();
-    auto start = glfwGetTime();
-    while (!window_->shouldClose()) {
+    auto start              = glfwGetTime();
+    auto last_gpu_report_at = start;
+    size_t frame_count      = 0;
+    while (!window_->shouldClose() && !input_engine_.playbackFinished()) {
+        GACHIBALL_PROFILE_ZONE("frame");
+        GACHIBALL_ALLOCATION_SCOPE("engine");
+        auto activity = windowActivity();
+        if (activity == EWindowActivity::HIDDEN) {
+            // NOTE: returns early on any event, e.g. the window is restored
+            glfwWaitEventsTimeout(settings_.idle.hidden_poll_period);
+            pollInput();
+            event_bus_.dispatch();
+            // NOTE: simulation is paused, the time spent hidden is skipped
+            start = glfwGetTime();
+            introspection_.poll(start);
+            frame_pacer_.reset();
+            continue;
+        }
+
+        frame_pacer_.wait();
+        frame_arena_.beginFrame();
+        metrics_.record(EMetric::FRAME_TIME_MS, frame_pacer_.frameTime() * 1e3);
+        size_t events = 0;
+
         ///////////////////////////////////////////////////////////////////////
         // NOTE: DRAW
-        auto [width, height] = window_->window_size();
-        glViewport(0, 0, width, height);
-        glClearColor(.2f, .3f, .3f, 1.f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        gpu_timer_.beginFrame();
 
-        auto projection = glm::perspective(
-            glm::radians(45.f),
-            static_cast<float>(width) / static_cast<float>(height),
-            0.1f,
-            100.f
-        );
-        auto vp = projection * camera_->view();
+        dynamic_resolution_.update(gpu_timer_.frameTimeMs());
 
-        for (const auto body : bodies_) {
-            auto model =
-                glm::translate(glm::mat4_cast(body->rotation), body->position);
-            body->mesh->draw(vp * model);
+        if (settings_.input.late_latch) {
+            // NOTE: cursor motion which arrived during the update still
+            // moves the camera of this frame, prepareFrame applies it to the
+            // view only. Events are queued and dispatched at the frame's
+            // poll as usual.
+            GACHIBALL_ALLOCATION_SCOPE("input");
+            glfwPollEvents();
         }
 
+        GACHIBALL_ALLOCATION_SCOPE("assets");
+        asset_loader_.update();
+
+        GACHIBALL_ALLOCATION_SCOPE("render");
+        auto [width, height] = window_->window_size();
+        prepareFrame(width, height);
+        render_graph_.execute();
+        latency_tracker_.submitFrame();
+
+        gpu_timer_.endFrame();
         window_->swapBuffers();
-        glfwPollEvents();
+        latency_tracker_.poll();
+
+        GACHIBALL_ALLOCATION_SCOPE("input");
+        events += pollInput(
+            activity == EWindowActivity::UNFOCUSED
+                ? start + settings_.idle.unfocused_frame_time
+                : 0.
+        );
+        GACHIBALL_ALLOCATION_SCOPE("events");
+        events += event_bus_.dispatch();
+        metrics_.record(EMetric::EVENTS_DISPATCHED, events);
 
-        auto duration = glfwGetTime() - start;
+        auto duration = settings_.fixed_frame_time > 0.
+                            ? settings_.fixed_frame_time
+                            : frame_pacer_.frameDelta();
         ///////////////////////////////////////////////////////////////////////
         // NOTE: update physics
-        physics_engine_.update(duration);
+        GACHIBALL_ALLOCATION_SCOPE("physics");
+        auto physics_start = glfwGetTime();
+        if (physics_engine_.update(duration, &world_)) {
+            auto physics_time = glfwGetTime() - physics_start;
+            metrics_.record(EMetric::PHYSICS_STEP_MS, physics_time * 1e3);
+            metrics_.record(
+                EMetric::BODIES_SIMULATED, physics_engine_.simulatedBodies()
+            );
+        }
 
         ///////////////////////////////////////////////////////////////////////
         // NOTE: update game
+        GACHIBALL_ALLOCATION_SCOPE("game");
+        {
+            GACHIBALL_PROFILE_ZONE("game update");
+            game->update(duration);
+        }
+        action_map_.clearEdges();
 
-        game->update(duration);
-
+        GACHIBALL_ALLOCATION_SCOPE("engine");
         start = glfwGetTime();
+        GACHIBALL_ALLOCATION_SCOPE("report");
+        introspection_.poll(start);
+        metrics_.setCapture(introspection_.clientCount() > 0);
+        metrics_.update(start);
+        if (start - last_gpu_report_at > kGpuTimingsReportPeriod) {
+            sampleMemoryUsage();
+            ReportMemoryUsage(std::cerr);
+            gpu_timer_.report(std::cerr);
+            frame_pacer_.report(std::cerr);
+            frame_arena_.report(std::cerr);
+            latency_tracker_.report(std::cerr);
+            if (auto dropped = event_dispatcher_.droppedEventCount(); dropped) {
+                std::cerr << "Dropped events: " << dropped << std::endl;
+            }
+            last_gpu_report_at = start;
+        }
+
+        if (++frame_count == settings_.frame_limit) {
+            break;
+        }
     }
+    GACHIBALL_ALLOCATION_SCOPE(nullptr);
     game->deinit();
 }
 
+EWindowActivity TGameEngineImpl::windowActivity() const {
+    // NOTE: recorded input must see the same frames every run. Idle frames
+    // while recording would advance the trace without an update and replay
+    // as full frames.
+    if (!settings_.idle.enabled || settings_.headless ||
+        !settings_.input.playback_path.empty() ||
+        !settings_.input.record_path.empty()) {
+        return EWindowActivity::ACTIVE;
+    }
+
+    auto [width, height] = window_->window_size();
+    if (window_->hidden() || width == 0 || height == 0) {
+        return EWindowActivity::HIDDEN;
+    }
+    if (!window_->focused()) {
+        return EWindowActivity::UNFOCUSED;
+    }
+    return EWindowActivity::ACTIVE;
+}
+
+size_t TGameEngineImpl::pollInput(double deadline) {
+    GACHIBALL_PROFILE_ZONE("poll input");
+    for (auto now = glfwGetTime(); now < deadline; now = glfwGetTime()) {
+        glfwWaitEventsTimeout(deadline - now);
+    }
+    glfwPollEvents();
+    input_engine_.flush();
+    // NOTE: input callbacks only queue events, handlers run here
+    return event_dispatcher_.dispatchEvents();
+}
+
+void TGameEngineImpl::initRenderGraph() {
+    backbuffer_ = render_graph_.importBackbuffer("backbuffer");
+
+    if (!dynamic_resolution_.enabled()) {
+        render_graph_.addPass(
+            "scene",
+            [this](TRenderPassBuilder &builder) {
+                builder.write(backbuffer_, ERenderAccess::COLOR_ATTACHMENT);
+            },
+            [this](const TRenderPassContext &) { drawScene(); }
+        );
+        return;
+    }
+
+    // NOTE: real sizes are set in prepareFrame
+    scene_color_ = render_graph_.createTexture(
+        "scene_color", {.width = 1, .height = 1, .format = GL_RGBA8}
+    );
+    scene_depth_ = render_graph_.createTexture(
+        "scene_depth", {.width = 1, .height = 1, .format = GL_DEPTH24_STENCIL8}
+    );
+
+    render_graph_.addPass(
+        "scene",
+        [this](TRenderPassBuilder &builder) {
+            builder.write(scene_color_, ERenderAccess::COLOR_ATTACHMENT);
+            builder.write(scene_depth_, ERenderAccess::DEPTH_ATTACHMENT);
+        },
+        [this](const TRenderPassContext &) { drawScene(); }
+    );
+    render_graph_.addPass(
+        "upscale",
+        [this](TRenderPassBuilder &builder) {
+            builder.read(scene_color_, ERenderAccess::TRANSFER);
+            builder.write(backbuffer_, ERenderAccess::COLOR_ATTACHMENT);
+        },
+        [this](const TRenderPassContext &context) { upscaleScene(context); }
+    );
+}
+
+void TGameEngineImpl::initIntrospection() {
+    if (!introspection_.enabled()) {
+        return;
+    }
+
+    introspection_.addCommand(
+        "stats",
+        "bodies, event tables and render resources",
+        [this](std::span<const std::string_view>, std::ostream &out) {
+            return writeStats(out);
+        }
+    );
+    introspection_.addCommand(
+        "metrics",
+        "frame metrics since the last export or since the client attached",
+        [this](std::span<const std::string_view>, std::ostream &out) {
+            metrics_.snapshot(out, glfwGetTime());
+            return true;
+        }
+    );
+    introspection_.addCommand(
+        "profile",
+        "on | off | export [path], CPU profiler capture",
+        [this](std::span<const std::string_view> args, std::ostream &out) {
+            if (args.size() == 2 && (args[1] == "on" || args[1] == "off")) {
+                SetProfilingEnabled(args[1] == "on");
+                return true;
+            }
+            if (args.size() < 2 || args.size() > 3 || args[1] != "export") {
+                return false;
+            }
+            std::string path{
+                args.size() == 3 ? args[2] : settings_.profile_path
+            };
+            if (!ExportChromeTrace(path)) {
+                return false;
+            }
+            out << "profile written to " << path << "\n";
+            return true;
+        }
+    );
+    introspection_.addCommand(
+        "memory",
+        "used, peak and budget bytes per subsystem",
+        [this](std::span<const std::string_view>, std::ostream &out) {
+            sampleMemoryUsage();
+            ReportMemoryUsage(out);
+            return true;
+        }
+    );
+    introspection_.addCommand(
+        "get",
+        "lists tunables",
+        [this](std::span<const std::string_view>, std::ostream &out) {
+            out << "simulation_step " << physics_engine_.simulationStep()
+                << "\ntarget_frame_rate " << frame_pacer_.targetFrameRate()
+                << "\nfixed_frame_time " << settings_.fixed_frame_time
+                << "\n";
+            return true;
+        }
+    );
+    introspection_.addCommand(
+        "set",
+        "<tunable> <value>, changes a tunable",
+        [this](std::span<const std::string_view> args, std::ostream &out) {
+            if (args.size() != 3) {
+                return false;
+            }
+            const auto *begin = args[2].data();
+            const auto *end   = begin + args[2].size();
+            double value      = 0.;
+            auto result       = std::from_chars(begin, end, value);
+            if (result.ec != std::errc{} || result.ptr != end) {
+                out << "bad value " << args[2] << "\n";
+                return false;
+            }
+            return setTunable(args[1], value);
+        }
+    );
+}
+
+bool TGameEngineImpl::writeStats(std::ostream &out) {
+    out << "entities " << world_.entityCount()
+        << "\narchetypes " << world_.archetypeCount()
+        << "\nsimulated_bodies " << physics_engine_.simulatedBodies()
+        << "\ninput_subscriptions " << event_dispatcher_.subscriptionCount()
+        << "\ndropped_input_events " << event_dispatcher_.droppedEventCount()
+        << "\nevent_bus_channels " << event_bus_.channelCount()
+        << "\nevent_bus_subscribers " << event_bus_.subscriberCount()
+        << "\nrender_passes " << render_graph_.activePassCount()
+        << "\nculled_render_passes " << render_graph_.culledPassCount()
+        << "\nrender_textures " << render_graph_.physicalTextureCount()
+        << "\nrender_buffers " << render_graph_.physicalBufferCount()
+        << "\nframe_arena_bytes " << frame_arena_.previous()->used()
+        << "\npending_assets " << asset_loader_.pendingCount()
+        << "\nframe_time_ms " << frame_pacer_.frameTime() * 1e3
+        << "\ngpu_frame_ms " << gpu_timer_.frameTimeMs() << "\n";
+    for (const auto &timing : gpu_timer_.timings()) {
+        out << "gpu_pass_ms " << timing.name << " " << timing.elapsed_ms
+            << "\n";
+    }
+    return true;
+}
+
+bool TGameEngineImpl::setTunable(std::string_view name, double value) {
+    if (name == "simulation_step" && value > 0.) {
+        physics_engine_.setSimulationStep(static_cast<float>(value));
+    } else if (name == "target_frame_rate" && value >= 0.) {
+        frame_pacer_.setTargetFrameRate(value);
+    } else if (name == "fixed_frame_time" && value >= 0.) {
+        settings_.fixed_frame_time = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void TGameEngineImpl::sampleMemoryUsage() {
+    SetMemoryUsage(EMemoryTag::PHYSICS, EMemoryPool::CPU, world_.memoryUsage());
+    SetMemoryUsage(
+        EMemoryTag::RENDER,
+        EMemoryPool::CPU,
+        scene_graph_.memoryUsage() + frame_arena_.current()->capacity() +
+            frame_arena_.previous()->capacity()
+    );
+    SetMemoryUsage(
+        EMemoryTag::EVENTS,
+        EMemoryPool::CPU,
+        event_dispatcher_.memoryUsage() + event_bus_.memoryUsage()
+    );
+}
+
+void TGameEngineImpl::prepareFrame(int width, int height) {
+    GACHIBALL_PROFILE_ZONE("prepare frame");
+    if (width != frame_.width || height != frame_.height) {
+        frame_.projection = glm::perspective(
+            glm::radians(45.f),
+            static_cast<float>(width) / static_cast<float>(height),
+            0.1f,
+            100.f
+        );
+        event_bus_.publish(TWindowResizeEvent{width, height});
+    }
+
+    frame_.width        = width;
+    frame_.height       = height;
+    frame_.scene_width  = width;
+    frame_.scene_height = height;
+
+    if (dynamic_resolution_.enabled()) {
+        // NOTE: targets are sized for the max scale, lower scales use a
+        // sub-rect so that scale changes never recompile the graph
+        auto max_scale = settings_.dynamic_resolution.max_scale;
+        TRenderTextureDesc target{
+            .width  = std::max(1, static_cast<int>(width * max_scale)),
+            .height = std::max(1, static_cast<int>(height * max_scale)),
+            .format = GL_RGBA8,
+        };
+        render_graph_.setTextureDesc(scene_color_, target);
+        target.format = GL_DEPTH24_STENCIL8;
+        render_graph_.setTextureDesc(scene_depth_, target);
+
+        auto scale = dynamic_resolution_.scale();
+        frame_.scene_width =
+            std::clamp(static_cast<int>(width * scale), 1, target.width);
+        frame_.scene_height =
+            std::clamp(static_cast<int>(height * scale), 1, target.height);
+    }
+
+    auto view = camera_->view();
+    if (settings_.input.late_latch) {
+        auto [x_delta, y_delta] = input_engine_.pendingMotion();
+        view                    = camera_->latchedView(x_delta, y_delta);
+    }
+    frame_.vp = frame_.projection * view;
+
+    buildDrawList();
+}
+
+void TGameEngineImpl::buildDrawList() {
+    // NOTE: unchanged bodies cost a compare, only their dirty subtrees are
+    // recomputed
+    world_.each<const TSceneNodeRef, const TTransform>(
+        [this](const TSceneNodeRef &ref, const TTransform &transform) {
+            scene_graph_.setLocalTransform(
+                ref.node, transform.position, transform.rotation
+            );
+        }
+    );
+    scene_graph_.update();
+
+    // NOTE: sized for every entity, unused tail is dropped with the arena
+    auto capacity = world_.entityCount();
+    auto *meshes  = frame_arena_.allocate<IMesh *>(capacity);
+    auto *models  = frame_arena_.allocate<glm::mat4>(capacity);
+    size_t count  = 0;
+    world_.each<const TSceneNodeRef, const TMeshRef>(
+        [&](const TSceneNodeRef &ref, const TMeshRef &mesh) {
+            meshes[count] = mesh.mesh;
+            models[count] = scene_graph_.worldMatrix(ref.node);
+            ++count;
+        }
+    );
+
+    draw_meshes_ = {meshes, count};
+    draw_models_ = {models, count};
+    draw_mvps_   = {frame_arena_.allocate<glm::mat4>(count), count};
+    MultiplyMatrices(
+        frame_.vp, draw_models_.data(), draw_models_.size(), draw_mvps_.data()
+    );
+}
+
+void TGameEngineImpl::drawScene() {
+    glViewport(0, 0, frame_.scene_width, frame_.scene_height);
+    // NOTE: the scene target is sized for the full resolution, clearing only
+    // the scaled sub-rect saves fill rate
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, frame_.scene_width, frame_.scene_height);
+    glClearColor(.2f, .3f, .3f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+
+    size_t triangles = 0;
+    for (size_t i = 0; i < draw_meshes_.size(); ++i) {
+        draw_meshes_[i]->draw(draw_mvps_[i]);
+        triangles += draw_meshes_[i]->triangleCount();
+    }
+    metrics_.record(EMetric::DRAW_CALLS, draw_meshes_.size());
+    metrics_.record(EMetric::TRIANGLES, triangles);
+}
+
+void TGameEngineImpl::upscaleScene(const TRenderPassContext &context) {
+    glBindFramebuffer(
+        GL_READ_FRAMEBUFFER, context.readFramebuffer(scene_color_)
+    );
+    glBlitFramebuffer(
+        0,
+        0,
+        frame_.scene_width,
+        frame_.scene_height,
+        0,
+        0,
+        frame_.width,
+        frame_.height,
+        GL_COLOR_BUFFER_BIT,
+        GL_LINEAR
+    );
+}
+
 void TGameEngineImpl::bindCamera(const ICamera *camera) {
     camera_ = camera;
 }
 
-void TGameEngineImpl::addBody(TBody *body) {
-    bodies_.insert(body);
+TEntity TGameEngineImpl::addBody(const TTransform &transform, TEntity parent) {
+    auto parent_node = kInvalidSceneNode;
+    if (parent != kInvalidEntity) {
+        auto *parent_ref = world_.get<const TSceneNodeRef>(parent);
+        assert(parent_ref && "parent body must be added first");
+        parent_node = parent_ref->node;
+    }
+    return world_.create(
+        transform, TSceneNodeRef{scene_graph_.createNode(parent_node)}
+    );
+}
+
+void TGameEngineImpl::removeBody(TEntity entity) {
+    if (auto *ref = world_.get<const TSceneNodeRef>(entity)) {
+        scene_graph_.destroyNode(ref->node);
+    }
+    world_.destroy(entity);
+}
+
+TWorld &TGameEngineImpl::world() {
+    return world_;
 }
 
-void TGameEngineImpl::addBody(TRigidBody *body) {
-    physics_engine_.addRigidBody(body);
-    addBody(static_cast<TBody *>(body));
+std::unique_ptr<IMesh> TGameEngineImpl::loadMesh(std::string path) {
+    return asset_loader_.loadMesh(std::move(path));
 }
 
-void TGameEngineImpl::removeBody(TBody *body) {
-    bodies_.erase(body);
+std::unique_ptr<IMesh> TGameEngineImpl::loadMesh(TMeshDecoder decoder) {
+    return asset_loader_.loadMesh(std::move(decoder));
 }
 
-void TGameEngineImpl::registerInputCallback(
+size_t TGameEngineImpl::pendingAssetCount() const {
+    return asset_loader_.pendingCount();
+}
+
+void TGameEngineImpl::grabCursor() {
+    window_->grabCursor();
+}
+
+void TGameEngineImpl::ungrabCursor() {
+    window_->ungrabCursor();
+}
+
+bool TGameEngineImpl::loadActionMap(const std::string &path) {
+    return action_map_.load(path);
+}
+
+const TActionMap &TGameEngineImpl::actions() const {
+    return action_map_;
+}
+
+bool TGameEngineImpl::exportProfile() {
+#ifndef GACHIBALL_PROFILING
+    std::cerr << "Profiling is not compiled in, the profile is empty"
+              << std::endl;
+#endif
+    if (!ExportChromeTrace(settings_.profile_path)) {
+        return false;
+    }
+    std::cerr << "Profile written to " << settings_.profile_path << std::endl;
+    return true;
+}
+
+TEventSubscription TGameEngineImpl::registerInputCallback(
     TInputEventType event_type, TInputCallback callback
 ) {
-    event_dispatcher_.registerEventHandler(
-        MakeEventType(std::move(event_type)),
-        [callback = std::move(callback)](TEvent event) {
-            callback(std::get<TInputEvent>(event));
-        }
+    return event_dispatcher_.subscribe(
+        std::move(event_type), std::move(callback)
     );
 }
 
+void TGameEngineImpl::unregisterInputCallback(TEventSubscription subscription) {
+    event_dispatcher_.unsubscribe(subscription);
+}
+
 void TGameEngineImpl::unregisterInputCallback(TInputEventType event_type) {
-    event_dispatcher_.registerEventHandler(
-        MakeEventType(std::move(event_type)), TEventHandler{}
-    );
+    event_dispatcher_.unsubscribeAll(std::move(event_type));
+}
+
+std::span<const TMouseMotionSample> TGameEngineImpl::mouseMotionSamples(
+) const {
+    return input_engine_.motionSamples();
+}
+
+TEventBus &TGameEngineImpl::eventBus() {
+    return event_bus_;
+}
+
+const std::vector<TGpuPassTiming> &TGameEngineImpl::gpuTimings() const {
+    return gpu_timer_.timings();
 }
 
 TGameEngine::TGameEngine() {
@@ -163,11 +751,11 @@ TGameEngine::TGameEngine() {
 TGameEngine::~TGameEngine() {
 }
 
-void TGameEngine::init() {
+void TGameEngine::init(TEngineSettings settings) {
     assert(!impl_);
 
     impl_ = std::make_unique<TGameEngineImpl>();
-    impl_->init();
+    impl_->init(std::move(settings));
 }
 
 void TGameEngine::deinit() {
@@ -188,30 +776,79 @@ void TGameEngine::bindCamera(const ICamera *camera) {
     impl_->bindCamera(camera);
 }
 
-void TGameEngine::addBody(TBody *body) {
+TEntity TGameEngine::addBody(const TTransform &transform, TEntity parent) {
+    assert(impl_);
+
+    return impl_->addBody(transform, parent);
+}
+
+void TGameEngine::removeBody(TEntity entity) {
+    assert(impl_);
+
+    impl_->removeBody(entity);
+}
+
+TWorld &TGameEngine::world() {
+    assert(impl_);
+
+    return impl_->world();
+}
+
+std::unique_ptr<IMesh> TGameEngine::loadMesh(std::string path) {
+    assert(impl_);
+
+    return impl_->loadMesh(std::move(path));
+}
+
+std::unique_ptr<IMesh> TGameEngine::loadMesh(TMeshDecoder decoder) {
+    assert(impl_);
+
+    return impl_->loadMesh(std::move(decoder));
+}
+
+size_t TGameEngine::pendingAssetCount() const {
+    assert(impl_);
+
+    return impl_->pendingAssetCount();
+}
+
+void TGameEngine::grabCursor() {
     assert(impl_);
 
-    impl_->addBody(body);
+    impl_->grabCursor();
 }
 
-void TGameEngine::addBody(TRigidBody *body) {
+void TGameEngine::ungrabCursor() {
     assert(impl_);
 
-    impl_->addBody(body);
+    impl_->ungrabCursor();
 }
 
-void TGameEngine::removeBody(TBody *body) {
+bool TGameEngine::loadActionMap(const std::string &path) {
     assert(impl_);
 
-    impl_->removeBody(body);
+    return impl_->loadActionMap(path);
 }
 
-void TGameEngine::registerInputCallback(
+const TActionMap &TGameEngine::actions() const {
+    assert(impl_);
+
+    return impl_->actions();
+}
+
+TEventSubscription TGameEngine::registerInputCallback(
     TInputEventType event_type, TInputCallback callback
 ) {
     assert(impl_);
 
-    impl_->registerInputCallback(std::move(event_type), std::move(callback));
+    return impl_->registerInputCallback(
+        std::move(event_type), std::move(callback)
+    );
+}
+
+void TGameEngine::unregisterInputCallback(TEventSubscription subscription) {
+    assert(impl_);
+    impl_->unregisterInputCallback(subscription);
 }
 
 void TGameEngine::unregisterInputCallback(TInputEventType event_type) {
@@ -219,4 +856,28 @@ void TGameEngine::unregisterInputCallback(TInputEventType event_type) {
     impl_->unregisterInputCallback(std::move(event_type));
 }
 
+std::span<const TMouseMotionSample> TGameEngine::mouseMotionSamples() const {
+    assert(impl_);
+
+    return impl_->mouseMotionSamples();
+}
+
+TEventBus &TGameEngine::eventBus() {
+    assert(impl_);
+
+    return impl_->eventBus();
+}
+
+const std::vector<TGpuPassTiming> &TGameEngine::gpuTimings() const {
+    assert(impl_);
+
+    return impl_->gpuTimings();
+}
+
+bool TGameEngine::exportProfile() {
+    assert(impl_);
+
+    return impl_->exportProfile();
+}
+
 };  // namespace NGameEngine
@@ -0,0 +1,82 @@
+#include "event_bus.hpp"
+
+#include <algorithm>
+
+namespace NGameEngine {
+
+namespace {
+
+template <typename TChannels>
+auto LowerBound(TChannels& channels, TEventTypeId type) {
+    return std::lower_bound(
+        channels.begin(),
+        channels.end(),
+        type,
+        [](const auto& channel, TEventTypeId type) {
+            return channel.first < type;
+        }
+    );
+}
+
+}  // namespace
+
+TEventBus::TEventBus() {
+}
+
+TEventBus::~TEventBus() {
+}
+
+void TEventBus::unsubscribe(TEventBusSubscription subscription) {
+    if (auto* channel = findChannel(subscription.type); channel) {
+        channel->unsubscribe(subscription.id);
+    }
+}
+
+size_t TEventBus::dispatch() {
+    size_t delivered = 0;
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        // NOTE: handlers may subscribe to new types, which inserts channels
+        delivered += channels_[i].second->deliver();
+    }
+    return delivered;
+}
+
+size_t TEventBus::channelCount() const {
+    return channels_.size();
+}
+
+size_t TEventBus::subscriberCount() const {
+    size_t count = 0;
+    for (const auto& [type, channel] : channels_) {
+        count += channel->subscriberCount();
+    }
+    return count;
+}
+
+size_t TEventBus::memoryUsage() const {
+    auto bytes = channels_.capacity() * sizeof(channels_[0]);
+    for (const auto& [type, channel] : channels_) {
+        bytes += channel->memoryUsage();
+    }
+    return bytes;
+}
+
+IEventChannel* TEventBus::findChannel(TEventTypeId type) const {
+    auto it = LowerBound(channels_, type);
+    if (it == channels_.end() || it->first != type) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+IEventChannel* TEventBus::findOrCreate(
+    TEventTypeId type, std::unique_ptr<IEventChannel> (*create)()
+) {
+    auto it = LowerBound(channels_, type);
+    if (it == channels_.end() || it->first != type) {
+        it = channels_.emplace(it, type, create());
+    }
+    return it->second.get();
+}
+
+}  // namespace NGameEngine
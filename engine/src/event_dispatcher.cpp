@@ -1,49 +1,289 @@
 #include "event_dispatcher.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "memory_tracker.hpp"
+#include "mpsc_queue.hpp"
+#include "profiler.hpp"
+
 namespace NGameEngine {
 
+namespace {
+
+static constexpr size_t kEventQueueCapacity = 1024;
+static constexpr size_t kEventBatchSize     = 64;
+
+// NOTE: dense event type id, handlers are looked up by it in a sorted index
+// so memory grows with subscriptions, not with the number of keys
+uint32_t InputEventKey(const TInputEventType& event_type) {
+    constexpr auto kKeyCount = static_cast<uint32_t>(EKey::KEY_COUNT);
+    constexpr auto kActionCount =
+        static_cast<uint32_t>(EKeyAction::KEY_ACTION_COUNT);
+
+    return (static_cast<uint32_t>(event_type.input_device) * kKeyCount +
+            static_cast<uint32_t>(event_type.key)) *
+               kActionCount +
+           static_cast<uint32_t>(event_type.key_action);
+}
+
+}  // namespace
+
 class TEventDispatcher::TImpl {
   public:
     TImpl() = default;
 
-    void raiseEvent(TEvent event);
-    void registerEventHandler(TEventType event, TEventHandler handler);
+    TEventSubscription subscribe(
+        TInputEventType event_type, TInputEventHandler handler
+    );
+    void unsubscribe(TEventSubscription subscription);
+    void unsubscribeAll(TInputEventType event_type);
+
+    void setInputObserver(TInputEventHandler observer);
+
+    void raiseEvent(const TEvent& event);
+
+    bool pushEvent(TEvent event);
+    size_t dispatchEvents();
+
+    size_t droppedEventCount() const;
+    size_t subscriptionCount() const;
+    size_t memoryUsage() const;
 
   private:
-    std::array<
-        std::array<
-            std::array<
-                TEventHandler,
-                static_cast<size_t>(EKeyAction::KEY_ACTION_COUNT)>,
-            static_cast<size_t>(EKey::KEY_COUNT)>,
-        static_cast<size_t>(EInputDevice::INPUT_DEVICE_COUNT)>
-        input_handlers_;
+    void raiseInputEvent(const TInputEvent& event);
+
+    void release(uint32_t slot);
+    // NOTE: applies deferred subscription changes, never runs during dispatch
+    void collect();
+
+  private:
+    struct TSlot {
+        TInputEventHandler handler;
+        uint32_t generation = 0;
+        bool alive          = false;
+    };
+
+    struct TIndexEntry {
+        uint32_t key;
+        uint32_t slot;
+    };
+
+  private:
+    // NOTE: deque keeps a handler in place while it runs, even if it
+    // subscribes new handlers
+    std::deque<TSlot> slots_;
+    std::vector<uint32_t> free_slots_;
+
+    // sorted by key, subscription order within the key
+    std::vector<TIndexEntry> index_;
+
+    TInputEventHandler observer_;
+
+    std::vector<TIndexEntry> added_;
+    std::vector<uint32_t> released_;
+    size_t dispatch_depth_ = 0;
+
+    TMpscQueue<TEvent, kEventQueueCapacity> queue_;
+    std::array<TEvent, kEventBatchSize> batch_;
+    std::atomic<size_t> dropped_events_ = 0;
 };
 
-void TEventDispatcher::TImpl::raiseEvent(TEvent event) {
+TEventSubscription TEventDispatcher::TImpl::subscribe(
+    TInputEventType event_type, TInputEventHandler handler
+) {
+    uint32_t slot;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    auto& record   = slots_[slot];
+    record.handler = std::move(handler);
+    record.alive   = true;
+
+    added_.push_back({InputEventKey(event_type), slot});
+    if (dispatch_depth_ == 0) {
+        collect();
+    }
+    return {slot, record.generation};
+}
+
+void TEventDispatcher::TImpl::unsubscribe(TEventSubscription subscription) {
+    if (subscription.index >= slots_.size()) {
+        return;
+    }
+
+    const auto& record = slots_[subscription.index];
+    if (!record.alive || record.generation != subscription.generation) {
+        return;
+    }
+
+    release(subscription.index);
+    if (dispatch_depth_ == 0) {
+        collect();
+    }
+}
+
+void TEventDispatcher::TImpl::unsubscribeAll(TInputEventType event_type) {
+    auto key = InputEventKey(event_type);
+
+    auto [first, last] = std::equal_range(
+        index_.begin(),
+        index_.end(),
+        TIndexEntry{key, 0},
+        [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }
+    );
+    for (auto it = first; it != last; ++it) {
+        if (slots_[it->slot].alive) {
+            release(it->slot);
+        }
+    }
+    for (const auto& entry : added_) {
+        if (entry.key == key && slots_[entry.slot].alive) {
+            release(entry.slot);
+        }
+    }
+
+    if (dispatch_depth_ == 0) {
+        collect();
+    }
+}
+
+void TEventDispatcher::TImpl::release(uint32_t slot) {
+    auto& record = slots_[slot];
+    record.alive = false;
+    ++record.generation;
+    released_.push_back(slot);
+}
+
+void TEventDispatcher::TImpl::collect() {
+    if (!released_.empty()) {
+        std::erase_if(index_, [this](const auto& entry) {
+            return !slots_[entry.slot].alive;
+        });
+        for (auto slot : released_) {
+            slots_[slot].handler.reset();
+            free_slots_.push_back(slot);
+        }
+        released_.clear();
+    }
+
+    for (const auto& entry : added_) {
+        if (!slots_[entry.slot].alive) {
+            continue;
+        }
+        auto it = std::upper_bound(
+            index_.begin(),
+            index_.end(),
+            entry,
+            [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }
+        );
+        index_.insert(it, entry);
+    }
+    added_.clear();
+}
+
+void TEventDispatcher::TImpl::raiseEvent(const TEvent& event) {
+    GACHIBALL_PROFILE_ZONE("raise event");
     if (const auto* input_event = std::get_if<TInputEvent>(&event);
         input_event) {
-        auto& handler =
-            input_handlers_[static_cast<size_t>(input_event->type.input_device)]
-                           [static_cast<size_t>(input_event->type.key)]
-                           [static_cast<size_t>(input_event->type.key_action)];
-        if (handler) {
-            handler(std::move(event));
+        raiseInputEvent(*input_event);
+    }
+}
+
+void TEventDispatcher::TImpl::setInputObserver(TInputEventHandler observer) {
+    observer_ = std::move(observer);
+}
+
+void TEventDispatcher::TImpl::raiseInputEvent(const TInputEvent& event) {
+    if (observer_) {
+        observer_(event);
+    }
+
+    auto [first, last] = std::equal_range(
+        index_.begin(),
+        index_.end(),
+        TIndexEntry{InputEventKey(event.type), 0},
+        [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }
+    );
+    if (first == last) {
+        return;
+    }
+
+    // NOTE: index_ is not modified while dispatch_depth_ is positive, so the
+    // range stays valid even if handlers change subscriptions
+    ++dispatch_depth_;
+    for (auto it = first; it != last; ++it) {
+        const auto& record = slots_[it->slot];
+        if (record.alive) {
+            record.handler(event);
         }
     }
+    --dispatch_depth_;
+
+    if (dispatch_depth_ == 0 && (!added_.empty() || !released_.empty())) {
+        collect();
+    }
 }
 
-void TEventDispatcher::TImpl::registerEventHandler(
-    TEventType event_type, TEventHandler handler
-) {
-    if (const auto* input_event = std::get_if<TInputEventType>(&event_type);
-        input_event) {
-        auto& h =
-            input_handlers_[static_cast<size_t>(input_event->input_device)]
-                           [static_cast<size_t>(input_event->key)]
-                           [static_cast<size_t>(input_event->key_action)];
-        h = std::move(handler);
+bool TEventDispatcher::TImpl::pushEvent(TEvent event) {
+    if (!queue_.tryPush(std::move(event))) {
+        dropped_events_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t TEventDispatcher::TImpl::dispatchEvents() {
+    // NOTE: events pushed by handlers, or by other threads meanwhile, wait
+    // for the next call, so the drain is bounded even if handlers keep
+    // producing
+    auto queued    = queue_.size();
+    size_t handled = 0;
+    while (handled < queued) {
+        auto batch_limit  = std::min(kEventBatchSize, queued - handled);
+        size_t batch_size = 0;
+        while (batch_size < batch_limit) {
+            auto event = queue_.tryPop();
+            if (!event) {
+                break;
+            }
+            batch_[batch_size++] = std::move(*event);
+        }
+
+        for (size_t i = 0; i < batch_size; ++i) {
+            raiseEvent(batch_[i]);
+        }
+        handled += batch_size;
+
+        if (batch_size < batch_limit) {
+            break;
+        }
     }
+    return handled;
+}
+
+size_t TEventDispatcher::TImpl::droppedEventCount() const {
+    return dropped_events_.load(std::memory_order_relaxed);
+}
+
+size_t TEventDispatcher::TImpl::subscriptionCount() const {
+    // NOTE: changes deferred during a dispatch are not counted yet
+    return index_.size();
+}
+
+size_t TEventDispatcher::TImpl::memoryUsage() const {
+    // NOTE: the queue and the batch are inline
+    return sizeof(*this) + slots_.size() * sizeof(TSlot) +
+           CapacityBytes(free_slots_) + CapacityBytes(index_) +
+           CapacityBytes(added_) + CapacityBytes(released_);
 }
 
 TEventDispatcher::TEventDispatcher()
@@ -53,14 +293,46 @@ TEventDispatcher::TEventDispatcher()
 TEventDispatcher::~TEventDispatcher() {
 }
 
-void TEventDispatcher::raiseEvent(TEvent event) {
-    impl_->raiseEvent(std::move(event));
+TEventSubscription TEventDispatcher::subscribe(
+    TInputEventType event_type, TInputEventHandler handler
+) {
+    return impl_->subscribe(std::move(event_type), std::move(handler));
 }
 
-void TEventDispatcher::registerEventHandler(
-    TEventType event_type, TEventHandler handler
-) {
-    impl_->registerEventHandler(std::move(event_type), std::move(handler));
+void TEventDispatcher::unsubscribe(TEventSubscription subscription) {
+    impl_->unsubscribe(subscription);
+}
+
+void TEventDispatcher::unsubscribeAll(TInputEventType event_type) {
+    impl_->unsubscribeAll(std::move(event_type));
+}
+
+void TEventDispatcher::setInputObserver(TInputEventHandler observer) {
+    impl_->setInputObserver(std::move(observer));
+}
+
+void TEventDispatcher::raiseEvent(const TEvent& event) {
+    impl_->raiseEvent(event);
+}
+
+bool TEventDispatcher::pushEvent(TEvent event) {
+    return impl_->pushEvent(std::move(event));
+}
+
+size_t TEventDispatcher::dispatchEvents() {
+    return impl_->dispatchEvents();
+}
+
+size_t TEventDispatcher::droppedEventCount() const {
+    return impl_->droppedEventCount();
+}
+
+size_t TEventDispatcher::subscriptionCount() const {
+    return impl_->subscriptionCount();
+}
+
+size_t TEventDispatcher::memoryUsage() const {
+    return impl_->memoryUsage();
 }
 
 }  // namespace NGameEngine
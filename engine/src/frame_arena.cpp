@@ -0,0 +1,133 @@
+#include "frame_arena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace NGameEngine {
+
+static constexpr size_t kArenaAlignment = alignof(std::max_align_t);
+
+TLinearArena::~TLinearArena() {
+    deinit();
+}
+
+void TLinearArena::init(size_t capacity) {
+    deinit();
+
+    if (capacity) {
+        buffer_ = static_cast<std::byte*>(
+            std::pmr::new_delete_resource()->allocate(capacity, kArenaAlignment)
+        );
+    }
+    capacity_ = capacity;
+    offset_   = 0;
+    peak_     = 0;
+}
+
+void TLinearArena::deinit() {
+    releaseOverflow();
+    if (buffer_) {
+        std::pmr::new_delete_resource()->deallocate(
+            buffer_, capacity_, kArenaAlignment
+        );
+    }
+    buffer_   = nullptr;
+    capacity_ = 0;
+    offset_   = 0;
+}
+
+void TLinearArena::reset() {
+    auto used = this->used();
+    auto peak = std::max(peak_, used);
+
+    if (overflow_.empty()) {
+        offset_ = 0;
+        peak_   = peak;
+        return;
+    }
+
+    // NOTE: the frame did not fit, grow so that the same load fits next time
+    init(std::bit_ceil(used));
+    peak_ = peak;
+}
+
+void* TLinearArena::do_allocate(size_t bytes, size_t alignment) {
+    auto base    = reinterpret_cast<uintptr_t>(buffer_);
+    auto aligned = (base + offset_ + alignment - 1) & ~(alignment - 1);
+    auto end     = aligned - base + bytes;
+    if (buffer_ && end <= capacity_) {
+        offset_ = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    auto* ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    overflow_.push_back({.ptr = ptr, .bytes = bytes, .alignment = alignment});
+    overflow_bytes_ += bytes;
+    return ptr;
+}
+
+void TLinearArena::do_deallocate(void*, size_t, size_t) {
+}
+
+bool TLinearArena::do_is_equal(const std::pmr::memory_resource& other
+) const noexcept {
+    return this == &other;
+}
+
+void TLinearArena::releaseOverflow() {
+    for (const auto& block : overflow_) {
+        std::pmr::new_delete_resource()->deallocate(
+            block.ptr, block.bytes, block.alignment
+        );
+    }
+    overflow_.clear();
+    overflow_bytes_ = 0;
+}
+
+size_t TLinearArena::capacity() const {
+    return capacity_;
+}
+
+size_t TLinearArena::used() const {
+    return offset_ + overflow_bytes_;
+}
+
+size_t TLinearArena::peak() const {
+    return peak_;
+}
+
+void TFrameArena::init(size_t capacity) {
+    for (auto& arena : arenas_) {
+        arena.init(capacity);
+    }
+    current_ = 0;
+}
+
+void TFrameArena::deinit() {
+    for (auto& arena : arenas_) {
+        arena.deinit();
+    }
+}
+
+void TFrameArena::beginFrame() {
+    current_ ^= 1;
+    arenas_[current_].reset();
+}
+
+void TFrameArena::report(std::ostream& out) {
+    auto peak     = std::max(arenas_[0].peak(), arenas_[1].peak());
+    auto capacity = std::min(arenas_[0].capacity(), arenas_[1].capacity());
+    out << "Frame arena: peak " << peak << " of " << capacity << " bytes"
+        << std::endl;
+}
+
+TLinearArena* TFrameArena::current() {
+    return &arenas_[current_];
+}
+
+TLinearArena* TFrameArena::previous() {
+    return &arenas_[current_ ^ 1];
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,99 @@
+#include "frame_pacer.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <thread>
+
+#include "profiler.hpp"
+
+namespace NGameEngine {
+
+void TFramePacer::init(const TFramePacerSettings& settings) {
+    settings_ = settings;
+    glfwSwapInterval(settings_.swap_interval);
+    setTargetFrameRate(settings_.target_frame_rate);
+}
+
+void TFramePacer::setTargetFrameRate(double target_frame_rate) {
+    settings_.target_frame_rate = target_frame_rate;
+    period_                     = 0.;
+    if (target_frame_rate > 0.) {
+        period_ = 1. / target_frame_rate;
+    }
+    reset();
+}
+
+void TFramePacer::reset() {
+    last_frame_  = glfwGetTime();
+    deadline_    = last_frame_ + period_;
+    frame_delta_ = period_;
+    frame_time_  = period_;
+}
+
+void TFramePacer::wait() {
+    GACHIBALL_PROFILE_ZONE("frame pacer wait");
+    auto now = glfwGetTime();
+
+    if (period_ > 0.) {
+        auto slack = deadline_ - now;
+        if (slack < 0.) {
+            ++missed_deadlines_;
+        } else {
+            slack_ms_.record(slack * 1000.);
+        }
+
+        if (slack > settings_.spin_threshold) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(
+                slack - settings_.spin_threshold
+            ));
+        }
+        while ((now = glfwGetTime()) < deadline_) {
+            std::this_thread::yield();
+        }
+
+        // NOTE: on schedule the delta is exactly the period, so wake up
+        // jitter does not leak into the simulation
+        frame_delta_ = slack < 0. ? now - last_frame_ : period_;
+        // NOTE: after a miss, schedule from now instead of catching up with
+        // a burst of short frames
+        deadline_ =
+            now - deadline_ > period_ ? now + period_ : deadline_ + period_;
+    } else {
+        frame_delta_ = now - last_frame_;
+    }
+
+    frame_time_ = now - last_frame_;
+    frame_time_ms_.record(frame_time_ * 1000.);
+    last_frame_ = now;
+}
+
+double TFramePacer::frameDelta() const {
+    return frame_delta_;
+}
+
+double TFramePacer::frameTime() const {
+    return frame_time_;
+}
+
+double TFramePacer::targetFrameRate() const {
+    return settings_.target_frame_rate;
+}
+
+void TFramePacer::report(std::ostream& out) {
+    out << "Frame time: p50 " << frame_time_ms_.percentile(0.5) << " ms | p99 "
+        << frame_time_ms_.percentile(0.99) << " ms | max "
+        << frame_time_ms_.max() << " ms";
+    if (period_ > 0.) {
+        out << " | slack p50 " << slack_ms_.percentile(0.5) << " ms | p5 "
+            << slack_ms_.percentile(0.05)
+            << " ms | missed: " << missed_deadlines_;
+    }
+    out << std::endl;
+
+    frame_time_ms_.reset();
+    slack_ms_.reset();
+    missed_deadlines_ = 0;
+}
+
+}  // namespace NGameEngine
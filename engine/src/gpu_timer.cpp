@@ -0,0 +1,293 @@
+#include "gpu_timer.hpp"
+
+// clang-format off
+#include <glad/gl.h>
+// clang-format on
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
+
+namespace NGameEngine {
+
+namespace {
+
+// NOTE: query sets are reused round-robin, a set is read back right before
+// it is reused, so results are kQueryBufferCount frames old
+static constexpr size_t kQueryBufferCount = 2;
+static constexpr size_t kMaxPassCount     = 32;
+
+struct TPassRecord {
+    std::string_view name;
+    size_t depth;
+    size_t begin_query;
+    size_t end_query;
+};
+
+struct TQuerySet {
+    // [0] and [1] are frame begin and end, the rest belong to passes
+    std::array<GLuint, 2 * kMaxPassCount + 2> queries;
+    std::vector<TPassRecord> passes;
+    size_t used_queries = 0;
+    bool pending        = false;
+};
+
+struct TPassStats {
+    std::string_view name;
+    double total_ms;
+    size_t samples;
+};
+
+}  // namespace
+
+class TGpuTimer::TImpl {
+  public:
+    TImpl();
+    ~TImpl();
+
+    void beginFrame();
+    void endFrame();
+
+    void beginPass(std::string_view name);
+    void endPass();
+
+    const std::vector<TGpuPassTiming>& timings() const;
+    double frameTimeMs() const;
+
+    void report(std::ostream& out);
+
+  private:
+    bool collect(TQuerySet& set);
+    GLuint nextQuery(size_t* index);
+
+  private:
+    std::array<TQuerySet, kQueryBufferCount> sets_;
+    size_t current_ = 0;
+
+    std::vector<size_t> open_passes_;
+
+    std::vector<TGpuPassTiming> timings_;
+    double frame_time_ms_ = 0.;
+
+    std::vector<TPassStats> stats_;
+    double frame_total_ms_ = 0.;
+    size_t frame_samples_  = 0;
+    size_t dropped_frames_ = 0;
+};
+
+TGpuTimer::TImpl::TImpl() {
+    for (auto& set : sets_) {
+        glGenQueries(set.queries.size(), set.queries.data());
+        set.passes.reserve(kMaxPassCount);
+    }
+    open_passes_.reserve(kMaxPassCount);
+    timings_.reserve(kMaxPassCount);
+}
+
+TGpuTimer::TImpl::~TImpl() {
+    for (auto& set : sets_) {
+        glDeleteQueries(set.queries.size(), set.queries.data());
+    }
+}
+
+GLuint TGpuTimer::TImpl::nextQuery(size_t* index) {
+    auto& set = sets_[current_];
+    *index    = set.used_queries++;
+    return set.queries[*index];
+}
+
+bool TGpuTimer::TImpl::collect(TQuerySet& set) {
+    GLint available = GL_FALSE;
+    // NOTE: frame end is issued last, so the whole set is ready with it
+    glGetQueryObjectiv(set.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+
+    auto read = [&set](size_t index) {
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(set.queries[index], GL_QUERY_RESULT, &value);
+        return value;
+    };
+    auto to_ms = [](GLuint64 begin, GLuint64 end) {
+        return static_cast<double>(end - begin) * 1e-6;
+    };
+
+    timings_.clear();
+    for (const auto& pass : set.passes) {
+        auto elapsed_ms = to_ms(read(pass.begin_query), read(pass.end_query));
+        timings_.push_back(TGpuPassTiming{
+            .name       = pass.name,
+            .depth      = pass.depth,
+            .elapsed_ms = elapsed_ms,
+        });
+
+        auto it = std::find_if(
+            stats_.begin(),
+            stats_.end(),
+            [&pass](const auto& stats) { return stats.name == pass.name; }
+        );
+        if (it == stats_.end()) {
+            stats_.push_back({pass.name, 0., 0});
+            it = std::prev(stats_.end());
+        }
+        it->total_ms += elapsed_ms;
+        ++it->samples;
+    }
+    frame_time_ms_ = to_ms(read(0), read(1));
+
+    frame_total_ms_ += frame_time_ms_;
+    ++frame_samples_;
+    return true;
+}
+
+void TGpuTimer::TImpl::beginFrame() {
+    auto& set = sets_[current_];
+    if (set.pending && !collect(set)) {
+        ++dropped_frames_;
+    }
+
+    set.passes.clear();
+    set.used_queries = 0;
+    set.pending      = false;
+    open_passes_.clear();
+
+    size_t index;
+    glQueryCounter(nextQuery(&index), GL_TIMESTAMP);
+    // NOTE: reserve [1] for the frame end
+    ++set.used_queries;
+}
+
+void TGpuTimer::TImpl::endFrame() {
+    assert(open_passes_.empty());
+
+    auto& set = sets_[current_];
+    glQueryCounter(set.queries[1], GL_TIMESTAMP);
+    set.pending = true;
+
+    current_ = (current_ + 1) % kQueryBufferCount;
+}
+
+void TGpuTimer::TImpl::beginPass(std::string_view name) {
+    auto& set = sets_[current_];
+    if (set.passes.size() == kMaxPassCount) {
+        // NOTE: pass is silently not measured
+        open_passes_.push_back(kMaxPassCount);
+        return;
+    }
+
+    auto& pass = set.passes.emplace_back(TPassRecord{
+        .name  = name,
+        .depth = open_passes_.size(),
+    });
+    glQueryCounter(nextQuery(&pass.begin_query), GL_TIMESTAMP);
+    open_passes_.push_back(set.passes.size() - 1);
+}
+
+void TGpuTimer::TImpl::endPass() {
+    assert(!open_passes_.empty());
+
+    auto pass_index = open_passes_.back();
+    open_passes_.pop_back();
+    if (pass_index == kMaxPassCount) {
+        return;
+    }
+
+    auto& pass = sets_[current_].passes[pass_index];
+    glQueryCounter(nextQuery(&pass.end_query), GL_TIMESTAMP);
+}
+
+const std::vector<TGpuPassTiming>& TGpuTimer::TImpl::timings() const {
+    return timings_;
+}
+
+double TGpuTimer::TImpl::frameTimeMs() const {
+    return frame_time_ms_;
+}
+
+void TGpuTimer::TImpl::report(std::ostream& out) {
+    if (frame_samples_ == 0) {
+        out << "GPU timings: no completed frames, dropped: " << dropped_frames_
+            << std::endl;
+        dropped_frames_ = 0;
+        return;
+    }
+
+    out << "GPU frame: " << frame_total_ms_ / frame_samples_ << " ms";
+    for (const auto& stats : stats_) {
+        if (stats.samples) {
+            out << " | " << stats.name << ": "
+                << stats.total_ms / stats.samples << " ms";
+        }
+    }
+    out << " (frames: " << frame_samples_ << ", dropped: " << dropped_frames_
+        << ")" << std::endl;
+
+    for (auto& stats : stats_) {
+        stats.total_ms = 0.;
+        stats.samples  = 0;
+    }
+    frame_total_ms_ = 0.;
+    frame_samples_  = 0;
+    dropped_frames_ = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TGpuTimer
+///////////////////////////////////////////////////////////////////////////////
+
+TGpuTimer::TGpuTimer() {
+}
+
+TGpuTimer::~TGpuTimer() {
+}
+
+void TGpuTimer::init() {
+    assert(!impl_);
+
+    impl_ = std::make_unique<TImpl>();
+}
+
+void TGpuTimer::deinit() {
+    impl_.reset();
+}
+
+void TGpuTimer::beginFrame() {
+    impl_->beginFrame();
+}
+
+void TGpuTimer::endFrame() {
+    impl_->endFrame();
+}
+
+void TGpuTimer::beginPass(std::string_view name) {
+    impl_->beginPass(name);
+}
+
+void TGpuTimer::endPass() {
+    impl_->endPass();
+}
+
+const std::vector<TGpuPassTiming>& TGpuTimer::timings() const {
+    return impl_->timings();
+}
+
+double TGpuTimer::frameTimeMs() const {
+    return impl_->frameTimeMs();
+}
+
+void TGpuTimer::report(std::ostream& out) {
+    impl_->report(out);
+}
+
+TGpuTimerScope::TGpuTimerScope(TGpuTimer* timer, std::string_view name)
+    : timer_(timer) {
+    timer_->beginPass(name);
+}
+
+TGpuTimerScope::~TGpuTimerScope() {
+    timer_->endPass();
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,120 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace NGameEngine {
+
+THistogram::THistogram(double min_value, double max_value, size_t sub_buckets)
+    : min_value_(min_value)
+    , max_value_(max_value)
+    , sub_buckets_(sub_buckets) {
+    assert(min_value_ > 0.);
+    assert(min_value_ < max_value_);
+    assert(sub_buckets_ > 0);
+
+    auto octaves = static_cast<size_t>(
+        std::ceil(std::log2(max_value_ / min_value_))
+    );
+    // NOTE: [0] holds values below min_value
+    buckets_.resize(1 + octaves * sub_buckets_);
+}
+
+size_t THistogram::bucketIndex(double value) const {
+    if (value < min_value_) {
+        return 0;
+    }
+
+    int exponent;
+    // NOTE: value / min_value = fraction * 2^exponent, fraction in [0.5, 1)
+    auto fraction = std::frexp(value / min_value_, &exponent);
+    auto octave   = static_cast<size_t>(exponent - 1);
+    auto sub      = static_cast<size_t>((2. * fraction - 1.) * sub_buckets_);
+
+    return std::min(1 + octave * sub_buckets_ + sub, buckets_.size() - 1);
+}
+
+double THistogram::bucketValue(size_t index) const {
+    if (index == 0) {
+        return min_value_;
+    }
+
+    auto octave = (index - 1) / sub_buckets_;
+    auto sub    = (index - 1) % sub_buckets_;
+    auto low    = std::ldexp(min_value_, static_cast<int>(octave));
+    // NOTE: middle of the bucket
+    return low * (1. + (static_cast<double>(sub) + 0.5) / sub_buckets_);
+}
+
+void THistogram::record(double value) {
+    ++buckets_[bucketIndex(value)];
+
+    min_ = count_ ? std::min(min_, value) : value;
+    max_ = count_ ? std::max(max_, value) : value;
+    sum_ += value;
+    ++count_;
+}
+
+void THistogram::merge(const THistogram& other) {
+    assert(buckets_.size() == other.buckets_.size());
+
+    if (!other.count_) {
+        return;
+    }
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+
+    min_ = count_ ? std::min(min_, other.min_) : other.min_;
+    max_ = count_ ? std::max(max_, other.max_) : other.max_;
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+void THistogram::reset() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    sum_   = 0.;
+    min_   = 0.;
+    max_   = 0.;
+}
+
+uint64_t THistogram::count() const {
+    return count_;
+}
+
+double THistogram::min() const {
+    return min_;
+}
+
+double THistogram::max() const {
+    return max_;
+}
+
+double THistogram::mean() const {
+    return count_ ? sum_ / static_cast<double>(count_) : 0.;
+}
+
+double THistogram::percentile(double p) const {
+    if (!count_) {
+        return 0.;
+    }
+
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(p, 0., 1.) * static_cast<double>(count_))
+    );
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // NOTE: exact extremes are known, never report past them
+            return std::clamp(bucketValue(i), min_, max_);
+        }
+    }
+    return max_;
+}
+
+}  // namespace NGameEngine
@@ -3,11 +3,19 @@
 #include <GLFW/glfw3.h>
 
 #include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "input_trace.hpp"
 
 namespace NGameEngine {
 
 namespace {
 
+// NOTE: samples beyond the limit are dropped, the aggregated delta still
+// covers them
+static constexpr size_t kMaxMotionSamples = 512;
+
 static void KeyCallback(void*, int key, int scancode, int action, int mods);
 static void MouseKeyCallback(void*, int key, int action, int mods);
 static void CursorPositionCallback(void*, double xpos, double ypos);
@@ -16,26 +24,83 @@ static void CursorPositionCallback(void*, double xpos, double ypos);
 
 class TInputEngine::TImpl {
   public:
-    TImpl(TWindow* window, TEventDispatcher* event_dispatcher);
+    TImpl(
+        TWindow* window,
+        TEventDispatcher* event_dispatcher,
+        TInputSettings settings
+    );
 
     void init();
     void deinit();
 
+    void flush();
+    std::span<const TMouseMotionSample> motionSamples() const;
+    std::pair<double, double> pendingMotion() const;
+
+    bool playbackFinished() const;
+
   public:
     void keyCallback(int key, int scancode, int action, int mods);
     void cursorPositionCallback(double xpos, double ypos);
     void mouseKeyCallback(int key, int action, int mods);
 
+  private:
+    // NOTE: timestamps are those of the trace during a playback
+    void handleKey(int key, int action, double timestamp);
+    void handleMouseKey(int key, int action, double timestamp);
+    void handleCursorPosition(double xpos, double ypos, double timestamp);
+
+    void pushMotion(double xpos, double ypos, double timestamp);
+    void flushMotion();
+
+    void record(TInputTraceRecord record);
+    void replay();
+
   private:
     TEventDispatcher* event_dispatcher_;
     TWindow* window_;
+    TInputSettings settings_;
 
     double prev_cursor_xpos_;
     double prev_cursor_ypos_;
+
+    // NOTE: latest position not yet sent in a MOVED event
+    bool motion_pending_ = false;
+    double motion_timestamp_;
+    double cursor_xpos_;
+    double cursor_ypos_;
+
+    // NOTE: latest reported position and the position at the last flush
+    double polled_xpos_;
+    double polled_ypos_;
+    double flushed_xpos_;
+    double flushed_ypos_;
+
+    std::vector<TMouseMotionSample> samples_;
+    std::vector<TMouseMotionSample> frame_samples_;
+
+    // NOTE: traces are keyed by poll, so playback is independent of timing
+    uint32_t poll_index_     = 0;
+    double poll_started_at_ = 0.;
+
+    bool recording_ = false;
+    TInputTraceWriter trace_writer_;
+
+    bool playing_back_ = false;
+    std::vector<TInputTraceRecord> trace_;
+    size_t next_record_ = 0;
 };
 
-TInputEngine::TImpl::TImpl(TWindow* window, TEventDispatcher* event_dispatcher)
-    : window_(window), event_dispatcher_(event_dispatcher) {
+TInputEngine::TImpl::TImpl(
+    TWindow* window,
+    TEventDispatcher* event_dispatcher,
+    TInputSettings settings
+)
+    : window_(window)
+    , event_dispatcher_(event_dispatcher)
+    , settings_(std::move(settings)) {
+    samples_.reserve(kMaxMotionSamples);
+    frame_samples_.reserve(kMaxMotionSamples);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -48,12 +113,49 @@ void TInputEngine::TImpl::init() {
     window_->registerCursorPositionCallback(CursorPositionCallback);
 
     std::tie(prev_cursor_xpos_, prev_cursor_ypos_) = window_->cursor_position();
+    cursor_xpos_ = polled_xpos_ = flushed_xpos_ = prev_cursor_xpos_;
+    cursor_ypos_ = polled_ypos_ = flushed_ypos_ = prev_cursor_ypos_;
+
+    if (settings_.raw_mouse_motion && !window_->enableRawMouseMotion()) {
+        std::cerr << "Raw mouse motion is not supported" << std::endl;
+    }
+
+    poll_started_at_ = glfwGetTime();
+
+    // NOTE: a trace starts with the cursor position, so the first delta of
+    // a playback does not depend on where the cursor happens to be
+    if (!settings_.playback_path.empty()) {
+        if (!ReadInputTrace(settings_.playback_path, &trace_)) {
+            std::exit(8);
+        }
+        playing_back_ = true;
+        if (!trace_.empty() &&
+            trace_.front().kind == EInputTraceKind::CURSOR_POSITION) {
+            prev_cursor_xpos_ = cursor_xpos_ = trace_.front().xpos;
+            prev_cursor_ypos_ = cursor_ypos_ = trace_.front().ypos;
+            polled_xpos_ = flushed_xpos_ = cursor_xpos_;
+            polled_ypos_ = flushed_ypos_ = cursor_ypos_;
+            next_record_ = 1;
+        }
+    } else if (!settings_.record_path.empty()) {
+        if (!trace_writer_.open(settings_.record_path)) {
+            std::exit(8);
+        }
+        recording_ = true;
+        record(TInputTraceRecord{
+            .kind = EInputTraceKind::CURSOR_POSITION,
+            .xpos = prev_cursor_xpos_,
+            .ypos = prev_cursor_ypos_,
+        });
+    }
 }
 
 void TInputEngine::TImpl::deinit() {
     window_->registerKeyboardKeyCallback(NULL);
     window_->registerMouseKeyCallback(NULL);
     window_->registerCursorPositionCallback(NULL);
+
+    trace_writer_.close();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,6 +227,79 @@ EKeyAction TranslateGLFWKeyAction(int action) {
 void TInputEngine::TImpl::keyCallback(
     int key, int scancode, int action, int mods
 ) {
+    if (playing_back_) {
+        return;
+    }
+    record({
+        .kind   = EInputTraceKind::KEY,
+        .key    = key,
+        .action = action,
+    });
+    handleKey(key, action, glfwGetTime());
+}
+
+void TInputEngine::TImpl::mouseKeyCallback(int key, int action, int mods) {
+    if (playing_back_) {
+        return;
+    }
+    record({
+        .kind   = EInputTraceKind::MOUSE_KEY,
+        .key    = key,
+        .action = action,
+    });
+    handleMouseKey(key, action, glfwGetTime());
+}
+
+void TInputEngine::TImpl::cursorPositionCallback(double xpos, double ypos) {
+    if (playing_back_) {
+        return;
+    }
+    record({
+        .kind = EInputTraceKind::CURSOR_POSITION,
+        .xpos = xpos,
+        .ypos = ypos,
+    });
+    handleCursorPosition(xpos, ypos, glfwGetTime());
+}
+
+void TInputEngine::TImpl::record(TInputTraceRecord record) {
+    if (!recording_) {
+        return;
+    }
+    record.poll = poll_index_;
+    record.time = static_cast<float>(glfwGetTime() - poll_started_at_);
+    trace_writer_.write(record);
+}
+
+void TInputEngine::TImpl::replay() {
+    for (; next_record_ < trace_.size() &&
+           trace_[next_record_].poll <= poll_index_;
+         ++next_record_) {
+        const auto& record = trace_[next_record_];
+        // NOTE: replayed polls start when recorded ones did, relative to
+        // the previous flush
+        auto timestamp = poll_started_at_ + record.time;
+        switch (record.kind) {
+            case EInputTraceKind::KEY:
+                handleKey(record.key, record.action, timestamp);
+                break;
+            case EInputTraceKind::MOUSE_KEY:
+                handleMouseKey(record.key, record.action, timestamp);
+                break;
+            case EInputTraceKind::CURSOR_POSITION:
+                handleCursorPosition(record.xpos, record.ypos, timestamp);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+bool TInputEngine::TImpl::playbackFinished() const {
+    return playing_back_ && next_record_ == trace_.size();
+}
+
+void TInputEngine::TImpl::handleKey(int key, int action, double timestamp) {
     auto input_event = TInputEvent{
         .type =
             {
@@ -132,12 +307,16 @@ void TInputEngine::TImpl::keyCallback(
                 .key          = TranslateGLFWKey(key),
                 .key_action   = TranslateGLFWKeyAction(action),
             },
-        .context = {.window = window_}
+        .context   = {.window = window_},
+        .timestamp = timestamp,
     };
-    event_dispatcher_->raiseEvent(MakeEvent(input_event));
+    flushMotion();
+    event_dispatcher_->pushEvent(MakeEvent(input_event));
 }
 
-void TInputEngine::TImpl::mouseKeyCallback(int key, int action, int mods) {
+void TInputEngine::TImpl::handleMouseKey(
+    int key, int action, double timestamp
+) {
     auto input_event = TInputEvent{
         .type =
             {
@@ -145,12 +324,70 @@ void TInputEngine::TImpl::mouseKeyCallback(int key, int action, int mods) {
                 .key          = TranslateGLFWKey(key),
                 .key_action   = TranslateGLFWKeyAction(action),
             },
-        .context = {.window = window_}
+        .context   = {.window = window_},
+        .timestamp = timestamp,
     };
-    event_dispatcher_->raiseEvent(MakeEvent(std::move(input_event)));
+    flushMotion();
+    event_dispatcher_->pushEvent(MakeEvent(std::move(input_event)));
 }
 
-void TInputEngine::TImpl::cursorPositionCallback(double xpos, double ypos) {
+void TInputEngine::TImpl::handleCursorPosition(
+    double xpos, double ypos, double timestamp
+) {
+    polled_xpos_ = xpos;
+    polled_ypos_ = ypos;
+    if (samples_.size() < kMaxMotionSamples) {
+        samples_.push_back({xpos, ypos, timestamp});
+    }
+
+    if (!settings_.coalesce_mouse_motion) {
+        pushMotion(xpos, ypos, timestamp);
+        return;
+    }
+
+    if (!motion_pending_) {
+        motion_timestamp_ = timestamp;
+    }
+    cursor_xpos_    = xpos;
+    cursor_ypos_    = ypos;
+    motion_pending_ = true;
+}
+
+void TInputEngine::TImpl::flushMotion() {
+    // NOTE: keeps motion ordered with button events of the same frame
+    if (motion_pending_) {
+        motion_pending_ = false;
+        pushMotion(cursor_xpos_, cursor_ypos_, motion_timestamp_);
+    }
+}
+
+void TInputEngine::TImpl::flush() {
+    if (playing_back_) {
+        replay();
+    }
+    flushMotion();
+    flushed_xpos_ = polled_xpos_;
+    flushed_ypos_ = polled_ypos_;
+
+    std::swap(samples_, frame_samples_);
+    samples_.clear();
+
+    ++poll_index_;
+    poll_started_at_ = glfwGetTime();
+}
+
+std::span<const TMouseMotionSample> TInputEngine::TImpl::motionSamples(
+) const {
+    return frame_samples_;
+}
+
+std::pair<double, double> TInputEngine::TImpl::pendingMotion() const {
+    return {polled_xpos_ - flushed_xpos_, polled_ypos_ - flushed_ypos_};
+}
+
+void TInputEngine::TImpl::pushMotion(
+    double xpos, double ypos, double timestamp
+) {
     auto input_event = TInputEvent{
         .type =
             {
@@ -166,8 +403,9 @@ void TInputEngine::TImpl::cursorPositionCallback(double xpos, double ypos) {
         .curr_ypos = ypos
     };
     input_event.context.window = window_;
+    input_event.timestamp      = timestamp;
 
-    event_dispatcher_->raiseEvent(MakeEvent(std::move(input_event)));
+    event_dispatcher_->pushEvent(MakeEvent(std::move(input_event)));
 
     prev_cursor_xpos_ = xpos;
     prev_cursor_ypos_ = ypos;
@@ -202,10 +440,16 @@ TInputEngine::TInputEngine()
 TInputEngine::~TInputEngine() {
 }
 
-void TInputEngine::init(TWindow* window, TEventDispatcher* event_dispatcher) {
+void TInputEngine::init(
+    TWindow* window,
+    TEventDispatcher* event_dispatcher,
+    TInputSettings settings
+) {
     assert(!impl_);
 
-    impl_ = std::make_unique<TInputEngine::TImpl>(window, event_dispatcher);
+    impl_ = std::make_unique<TInputEngine::TImpl>(
+        window, event_dispatcher, std::move(settings)
+    );
     impl_->init();
     input_engine = impl_.get();
 }
@@ -218,4 +462,28 @@ void TInputEngine::deinit() {
     impl_.reset();
 }
 
+void TInputEngine::flush() {
+    assert(impl_);
+
+    impl_->flush();
+}
+
+std::span<const TMouseMotionSample> TInputEngine::motionSamples() const {
+    assert(impl_);
+
+    return impl_->motionSamples();
+}
+
+std::pair<double, double> TInputEngine::pendingMotion() const {
+    assert(impl_);
+
+    return impl_->pendingMotion();
+}
+
+bool TInputEngine::playbackFinished() const {
+    assert(impl_);
+
+    return impl_->playbackFinished();
+}
+
 }  // namespace NGameEngine
@@ -0,0 +1,110 @@
+#include "input_trace.hpp"
+
+#include <array>
+#include <bit>
+#include <iostream>
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr std::array<char, 4> kTraceMagic{'G', 'B', 'I', 'T'};
+static constexpr uint32_t kTraceVersion = 1;
+
+static_assert(
+    std::endian::native == std::endian::little,
+    "input traces are stored in host byte order"
+);
+
+template <typename T>
+void Write(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool Read(std::istream& in, T* value) {
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char*>(value), sizeof(*value))
+    );
+}
+
+}  // namespace
+
+bool TInputTraceWriter::open(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        std::cerr << "Failed to open input trace " << path << std::endl;
+        return false;
+    }
+
+    out_.write(kTraceMagic.data(), kTraceMagic.size());
+    Write(out_, kTraceVersion);
+    return true;
+}
+
+void TInputTraceWriter::write(const TInputTraceRecord& record) {
+    if (!out_.is_open()) {
+        return;
+    }
+
+    Write(out_, record.kind);
+    Write(out_, record.poll);
+    Write(out_, record.time);
+    if (record.kind == EInputTraceKind::CURSOR_POSITION) {
+        Write(out_, record.xpos);
+        Write(out_, record.ypos);
+    } else {
+        Write(out_, record.key);
+        Write(out_, record.action);
+    }
+}
+
+void TInputTraceWriter::close() {
+    if (out_.is_open()) {
+        out_.close();
+    }
+}
+
+bool ReadInputTrace(
+    const std::string& path, std::vector<TInputTraceRecord>* records
+) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        std::cerr << "Failed to open input trace " << path << std::endl;
+        return false;
+    }
+
+    std::array<char, 4> magic;
+    uint32_t version = 0;
+    in.read(magic.data(), magic.size());
+    if (!in || magic != kTraceMagic || !Read(in, &version) ||
+        version != kTraceVersion) {
+        std::cerr << path << " is not an input trace" << std::endl;
+        return false;
+    }
+
+    records->clear();
+    TInputTraceRecord record;
+    while (Read(in, &record.kind)) {
+        if (record.kind >= EInputTraceKind::INPUT_TRACE_KIND_COUNT ||
+            !Read(in, &record.poll) || !Read(in, &record.time)) {
+            std::cerr << path << " is corrupted" << std::endl;
+            return false;
+        }
+
+        bool ok;
+        if (record.kind == EInputTraceKind::CURSOR_POSITION) {
+            ok = Read(in, &record.xpos) && Read(in, &record.ypos);
+        } else {
+            ok = Read(in, &record.key) && Read(in, &record.action);
+        }
+        if (!ok) {
+            std::cerr << path << " is truncated" << std::endl;
+            return false;
+        }
+        records->push_back(record);
+    }
+    return true;
+}
+
+}  // namespace NGameEngine
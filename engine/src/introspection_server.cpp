@@ -0,0 +1,228 @@
+#include "introspection_server.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr int kListenBacklog     = 4;
+static constexpr size_t kMaxLineLength  = 4096;
+static constexpr size_t kMaxArgs        = 16;
+static constexpr size_t kReadBufferSize = 1024;
+
+static constexpr std::string_view kBlanks = " \t\r";
+
+}  // namespace
+
+TIntrospectionServer::~TIntrospectionServer() {
+    deinit();
+}
+
+bool TIntrospectionServer::init(const TIntrospectionSettings& settings) {
+    deinit();
+
+    settings_ = settings;
+    if (settings_.socket_path.empty()) {
+        return true;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (settings_.socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Introspection socket path is too long: "
+                  << settings_.socket_path << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, settings_.socket_path.c_str());
+
+    listen_fd_ =
+        socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Failed to create introspection socket: "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // NOTE: a socket file left by a crashed run would fail the bind, any
+    // other file at the path is not ours to remove
+    struct stat status;
+    if (lstat(address.sun_path, &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            std::cerr << "Introspection socket path is taken by a non-socket: "
+                      << settings_.socket_path << std::endl;
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+        unlink(address.sun_path);
+    }
+    auto* socket_address = reinterpret_cast<sockaddr*>(&address);
+    if (bind(listen_fd_, socket_address, sizeof(address)) < 0 ||
+        listen(listen_fd_, kListenBacklog) < 0) {
+        std::cerr << "Failed to listen on " << settings_.socket_path << ": "
+                  << std::strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    std::cerr << "Introspection listens on " << settings_.socket_path
+              << std::endl;
+    next_poll_ = 0.;
+    return true;
+}
+
+void TIntrospectionServer::deinit() {
+    for (auto& client : clients_) {
+        close(client.fd);
+    }
+    clients_.clear();
+
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(settings_.socket_path.c_str());
+        listen_fd_ = -1;
+    }
+}
+
+void TIntrospectionServer::addCommand(
+    std::string name, std::string help, TIntrospectionCommand command
+) {
+    commands_.push_back({
+        .name    = std::move(name),
+        .help    = std::move(help),
+        .command = std::move(command),
+    });
+}
+
+void TIntrospectionServer::poll(double now) {
+    if (listen_fd_ < 0 || now < next_poll_) {
+        return;
+    }
+    next_poll_ = now + settings_.poll_period;
+
+    acceptClients();
+    std::erase_if(clients_, [this](TClient& client) {
+        // NOTE: a client which closed its end still gets the answers
+        auto alive = readClient(client) && flushClient(client);
+        if (alive && !(client.closed && client.output.empty())) {
+            return false;
+        }
+        close(client.fd);
+        return true;
+    });
+}
+
+void TIntrospectionServer::acceptClients() {
+    for (;;) {
+        auto fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd < 0) {
+            return;
+        }
+        clients_.push_back({.fd = fd});
+    }
+}
+
+bool TIntrospectionServer::readClient(TClient& client) {
+    std::array<char, kReadBufferSize> buffer;
+    while (!client.closed) {
+        auto size = recv(client.fd, buffer.data(), buffer.size(), 0);
+        if (size < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client.closed = size == 0;
+        client.input.append(buffer.data(), size);
+
+        size_t begin = 0;
+        auto end     = client.input.find('\n');
+        while (end != std::string::npos) {
+            execute(
+                std::string_view{client.input}.substr(begin, end - begin),
+                client.output
+            );
+            begin = end + 1;
+            end   = client.input.find('\n', begin);
+        }
+        client.input.erase(0, begin);
+
+        if (client.input.size() > kMaxLineLength) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TIntrospectionServer::flushClient(TClient& client) {
+    while (!client.output.empty()) {
+        auto size = send(
+            client.fd,
+            client.output.data(),
+            client.output.size(),
+            MSG_NOSIGNAL
+        );
+        if (size < 0) {
+            // NOTE: the client reads slowly, the rest goes on the next poll
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client.output.erase(0, size);
+    }
+    return true;
+}
+
+void TIntrospectionServer::execute(std::string_view line, std::string& output) {
+    std::array<std::string_view, kMaxArgs> args;
+    size_t arg_count = 0;
+    auto begin       = line.find_first_not_of(kBlanks);
+    while (begin != std::string_view::npos && arg_count < kMaxArgs) {
+        // NOTE: substr clamps the length of the last word
+        auto end          = line.find_first_of(kBlanks, begin);
+        args[arg_count++] = line.substr(begin, end - begin);
+        begin             = line.find_first_not_of(kBlanks, end);
+    }
+    if (!arg_count) {
+        return;
+    }
+
+    std::ostringstream out;
+    bool ok = false;
+    if (args[0] == "help") {
+        for (const auto& entry : commands_) {
+            out << entry.name << " - " << entry.help << "\n";
+        }
+        ok = true;
+    } else {
+        auto it = std::find_if(
+            commands_.begin(),
+            commands_.end(),
+            [&](const TCommandEntry& entry) { return entry.name == args[0]; }
+        );
+        if (it == commands_.end()) {
+            out << "unknown command " << args[0] << ", try help\n";
+        } else {
+            ok = it->command(std::span{args.data(), arg_count}, out);
+        }
+    }
+    out << (ok ? "ok\n" : "error\n");
+    output += out.str();
+}
+
+bool TIntrospectionServer::enabled() const {
+    return listen_fd_ >= 0;
+}
+
+size_t TIntrospectionServer::clientCount() const {
+    return clients_.size();
+}
+
+}  // namespace NGameEngine
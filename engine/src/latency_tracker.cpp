@@ -0,0 +1,203 @@
+#include "latency_tracker.hpp"
+
+// clang-format off
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <string_view>
+
+#include "histogram.hpp"
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr size_t kDeviceCount =
+    static_cast<size_t>(EInputDevice::INPUT_DEVICE_COUNT);
+static constexpr size_t kActionCount =
+    static_cast<size_t>(EKeyAction::KEY_ACTION_COUNT);
+// NOTE: latency is tracked per device and action, not per key
+static constexpr size_t kTypeCount = kDeviceCount * kActionCount;
+
+static constexpr size_t kMaxFramesInFlight = 8;
+
+static constexpr double kNoInput = std::numeric_limits<double>::infinity();
+
+static constexpr std::array<std::string_view, kDeviceCount> kDeviceNames{
+    "unknown",
+    "keyboard",
+    "mouse",
+};
+static constexpr std::array<std::string_view, kActionCount> kActionNames{
+    "unknown",
+    "pressed",
+    "released",
+    "moved",
+};
+
+size_t TypeIndex(const TInputEventType& type) {
+    return static_cast<size_t>(type.input_device) * kActionCount +
+           static_cast<size_t>(type.key_action);
+}
+
+struct TFrameRecord {
+    GLsync fence;
+    // NOTE: earliest input timestamp of each type reflected by the frame
+    std::array<double, kTypeCount> input_times;
+};
+
+}  // namespace
+
+class TLatencyTracker::TImpl {
+  public:
+    TImpl();
+    ~TImpl();
+
+    void onInputEvent(const TInputEvent& event);
+
+    void submitFrame();
+    void poll();
+
+    void report(std::ostream& out);
+
+  private:
+    std::array<double, kTypeCount> pending_;
+    bool has_pending_ = false;
+
+    // NOTE: ring of submitted frames, oldest first
+    std::array<TFrameRecord, kMaxFramesInFlight> frames_;
+    size_t first_frame_ = 0;
+    size_t frame_count_ = 0;
+    size_t skipped_     = 0;
+
+    std::array<THistogram, kTypeCount> histograms_;
+};
+
+TLatencyTracker::TImpl::TImpl() {
+    pending_.fill(kNoInput);
+}
+
+TLatencyTracker::TImpl::~TImpl() {
+    for (size_t i = 0; i < frame_count_; ++i) {
+        glDeleteSync(frames_[(first_frame_ + i) % kMaxFramesInFlight].fence);
+    }
+}
+
+void TLatencyTracker::TImpl::onInputEvent(const TInputEvent& event) {
+    // NOTE: events raised by code rather than a device have no timestamp
+    if (event.timestamp <= 0.) {
+        return;
+    }
+
+    auto& pending = pending_[TypeIndex(event.type)];
+    pending       = std::min(pending, event.timestamp);
+    has_pending_  = true;
+}
+
+void TLatencyTracker::TImpl::submitFrame() {
+    // NOTE: frames without new input need no fence
+    if (!has_pending_) {
+        return;
+    }
+    if (frame_count_ == kMaxFramesInFlight) {
+        // NOTE: input stays pending and is attributed to a later frame
+        ++skipped_;
+        return;
+    }
+
+    auto& frame = frames_[(first_frame_ + frame_count_) % kMaxFramesInFlight];
+    frame.fence       = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.input_times = pending_;
+    ++frame_count_;
+
+    pending_.fill(kNoInput);
+    has_pending_ = false;
+}
+
+void TLatencyTracker::TImpl::poll() {
+    while (frame_count_) {
+        auto& frame = frames_[first_frame_];
+        auto status = glClientWaitSync(frame.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED &&
+            status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        auto now = glfwGetTime();
+        for (size_t i = 0; i < kTypeCount; ++i) {
+            if (frame.input_times[i] != kNoInput) {
+                histograms_[i].record((now - frame.input_times[i]) * 1000.);
+            }
+        }
+
+        glDeleteSync(frame.fence);
+        first_frame_ = (first_frame_ + 1) % kMaxFramesInFlight;
+        --frame_count_;
+    }
+}
+
+void TLatencyTracker::TImpl::report(std::ostream& out) {
+    for (size_t i = 0; i < kTypeCount; ++i) {
+        auto& histogram = histograms_[i];
+        if (!histogram.count()) {
+            continue;
+        }
+
+        out << "Input latency " << kDeviceNames[i / kActionCount] << " "
+            << kActionNames[i % kActionCount] << ": p50 "
+            << histogram.percentile(0.5) << " ms | p95 "
+            << histogram.percentile(0.95) << " ms | p99 "
+            << histogram.percentile(0.99)
+            << " ms (samples: " << histogram.count() << ")" << std::endl;
+        histogram.reset();
+    }
+    if (skipped_) {
+        out << "Input latency: " << skipped_
+            << " frames were not tracked, too many frames in flight"
+            << std::endl;
+        skipped_ = 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TLatencyTracker
+///////////////////////////////////////////////////////////////////////////////
+
+TLatencyTracker::TLatencyTracker() {
+}
+
+TLatencyTracker::~TLatencyTracker() {
+}
+
+void TLatencyTracker::init() {
+    assert(!impl_);
+
+    impl_ = std::make_unique<TImpl>();
+}
+
+void TLatencyTracker::deinit() {
+    impl_.reset();
+}
+
+void TLatencyTracker::onInputEvent(const TInputEvent& event) {
+    impl_->onInputEvent(event);
+}
+
+void TLatencyTracker::submitFrame() {
+    impl_->submitFrame();
+}
+
+void TLatencyTracker::poll() {
+    impl_->poll();
+}
+
+void TLatencyTracker::report(std::ostream& out) {
+    impl_->report(out);
+}
+
+}  // namespace NGameEngine
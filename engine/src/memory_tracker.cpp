@@ -0,0 +1,166 @@
+#include "memory_tracker.hpp"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr size_t kMemoryPoolCount =
+    static_cast<size_t>(EMemoryPool::MEMORY_POOL_COUNT);
+
+static constexpr std::array<std::string_view, kMemoryTagCount> kTagNames{
+    "physics",
+    "render",
+    "events",
+    "assets",
+};
+static constexpr std::array<std::string_view, kMemoryPoolCount> kPoolNames{
+    "cpu",
+    "gpu",
+};
+
+struct TMemoryCounter {
+    std::atomic<int64_t> used{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<int64_t> budget{0};
+    std::atomic<bool> exceeded{false};
+};
+
+std::array<std::array<TMemoryCounter, kMemoryTagCount>, kMemoryPoolCount>
+    counters;
+std::atomic<bool> strict_budgets{false};
+
+TMemoryCounter& Counter(EMemoryTag tag, EMemoryPool pool) {
+    return counters[static_cast<size_t>(pool)][static_cast<size_t>(tag)];
+}
+
+void OnUsageChanged(EMemoryTag tag, EMemoryPool pool, int64_t used) {
+    auto& counter = Counter(tag, pool);
+
+    auto peak = counter.peak.load(std::memory_order_relaxed);
+    while (used > peak && !counter.peak.compare_exchange_weak(peak, used)) {
+    }
+
+    auto budget = counter.budget.load(std::memory_order_relaxed);
+    if (!budget || used <= budget) {
+        counter.exceeded.store(false, std::memory_order_relaxed);
+        return;
+    }
+    // NOTE: warn once per crossing, not on every allocation above it
+    if (counter.exceeded.exchange(true, std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::cerr << "Memory budget exceeded: "
+              << kTagNames[static_cast<size_t>(tag)] << " "
+              << kPoolNames[static_cast<size_t>(pool)] << " uses " << used
+              << " of " << budget << " bytes" << std::endl;
+    if (strict_budgets.load(std::memory_order_relaxed)) {
+        std::exit(10);
+    }
+}
+
+}  // namespace
+
+void SetMemoryBudgets(const TMemoryBudgetSettings& settings) {
+    strict_budgets.store(settings.strict, std::memory_order_relaxed);
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        auto tag = static_cast<EMemoryTag>(i);
+        Counter(tag, EMemoryPool::CPU).budget = settings.cpu[i];
+        Counter(tag, EMemoryPool::GPU).budget = settings.gpu[i];
+    }
+
+    // NOTE: usage recorded before the budgets were known is checked too
+    for (size_t pool = 0; pool < kMemoryPoolCount; ++pool) {
+        for (size_t i = 0; i < kMemoryTagCount; ++i) {
+            auto tag    = static_cast<EMemoryTag>(i);
+            auto memory = static_cast<EMemoryPool>(pool);
+            OnUsageChanged(tag, memory, Counter(tag, memory).used.load());
+        }
+    }
+}
+
+void AddMemoryUsage(EMemoryTag tag, EMemoryPool pool, int64_t bytes) {
+    auto& counter = Counter(tag, pool);
+    auto used =
+        counter.used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    OnUsageChanged(tag, pool, used);
+}
+
+void SetMemoryUsage(EMemoryTag tag, EMemoryPool pool, size_t bytes) {
+    auto used = static_cast<int64_t>(bytes);
+    Counter(tag, pool).used.store(used, std::memory_order_relaxed);
+    OnUsageChanged(tag, pool, used);
+}
+
+size_t MemoryUsage(EMemoryTag tag, EMemoryPool pool) {
+    auto used = Counter(tag, pool).used.load(std::memory_order_relaxed);
+    return static_cast<size_t>(std::max<int64_t>(used, 0));
+}
+
+void ReportMemoryUsage(std::ostream& out) {
+    for (size_t pool = 0; pool < kMemoryPoolCount; ++pool) {
+        out << "Memory " << kPoolNames[pool] << ":";
+        for (size_t i = 0; i < kMemoryTagCount; ++i) {
+            const auto& counter = counters[pool][i];
+            out << (i ? " | " : " ") << kTagNames[i] << " "
+                << counter.used.load() << " (peak " << counter.peak.load();
+            if (auto budget = counter.budget.load(); budget) {
+                out << ", budget " << budget;
+            }
+            out << ")";
+        }
+        out << " bytes" << std::endl;
+    }
+}
+
+size_t TextureByteSize(uint32_t format, int width, int height, int levels) {
+    // NOTE: bits, block compressed formats average below a byte per texel
+    size_t bits_per_texel = 32;
+    switch (format) {
+        case GL_R8:
+            bits_per_texel = 8;
+            break;
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            bits_per_texel = 16;
+            break;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:
+            bits_per_texel = 64;
+            break;
+        case GL_RGBA32F:
+            bits_per_texel = 128;
+            break;
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            bits_per_texel = 4;
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            bits_per_texel = 8;
+            break;
+        default:
+            // NOTE: RGBA8, depth 24 stencil 8, 32 bit single channel and
+            // RGB8, which drivers pad to four bytes
+            break;
+    }
+
+    size_t texels = 0;
+    for (int level = 0; level < std::max(levels, 1); ++level) {
+        texels += static_cast<size_t>(std::max(width >> level, 1)) *
+                  static_cast<size_t>(std::max(height >> level, 1));
+    }
+    return texels * bits_per_texel / 8;
+}
+
+}  // namespace NGameEngine
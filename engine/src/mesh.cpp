@@ -5,11 +5,28 @@
 #include <GL/gl.h>
 // clang-format on
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <array>
+#include <cerrno>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include <vector>
 
+#include "frame_arena.hpp"
+#include "memory_tracker.hpp"
+#include "mesh_asset.hpp"
+#include "profiler.hpp"
+
 namespace NGameEngine {
 
 static const glm::vec4 kDefaultVertexColor = {1.0f, 0.5f, 0.2f, 1.0f};
@@ -52,38 +69,74 @@ static const struct {
 
 namespace {
 
+// NOTE: GL objects are never deleted, meshes may outlive the context which
+// takes them along. Their bytes stay accounted for the same reason, so a
+// mesh dropped early shows up as the leak it is.
 class TMesh : public IMesh {
   public:
-    TMesh(GLuint vao, GLuint shader_program, size_t vertices_count);
+    TMesh(
+        GLuint vao,
+        GLuint shader_program,
+        size_t vertices_count,
+        size_t buffer_bytes,
+        GLenum index_type           = GL_UNSIGNED_INT,
+        const glm::mat4& dequantize = glm::mat4{1.f}
+    );
     ~TMesh() override = default;
     void draw(const glm::mat4x4& mvp) override;
 
+  public:
+    // getters
+    size_t triangleCount() const override;
+
   private:
     GLuint vao_;
     GLuint shader_program_;
 
     size_t vertices_count_;
+    size_t buffer_bytes_;
+    GLenum index_type_;
+    // NOTE: maps quantized positions to model space, identity otherwise
+    glm::mat4 dequantize_;
 };
 
-TMesh::TMesh(GLuint vao, GLuint shader_program, size_t vertices_count)
+TMesh::TMesh(
+    GLuint vao,
+    GLuint shader_program,
+    size_t vertices_count,
+    size_t buffer_bytes,
+    GLenum index_type,
+    const glm::mat4& dequantize
+)
     : vao_(vao)
     , shader_program_(shader_program)
-    , vertices_count_(vertices_count) {
+    , vertices_count_(vertices_count)
+    , buffer_bytes_(buffer_bytes)
+    , index_type_(index_type)
+    , dequantize_(dequantize) {
+    AddMemoryUsage(EMemoryTag::ASSETS, EMemoryPool::GPU, buffer_bytes_);
     std::cerr << "Mesh created" << std::endl
               << "vao: " << vao_ << std::endl
               << "shader_program: " << shader_program_ << std::endl
-              << "vertices_count: " << vertices_count_ << std::endl;
+              << "vertices_count: " << vertices_count_ << std::endl
+              << "buffer_bytes: " << buffer_bytes_ << std::endl;
 }
 
 void TMesh::draw(const glm::mat4x4& mvp) {
+    GACHIBALL_PROFILE_ZONE("mesh draw");
     auto mvp_location = glGetUniformLocation(shader_program_, "mvp");
+    auto model_mvp    = mvp * dequantize_;
     glUseProgram(shader_program_);
-    glUniformMatrix4fv(mvp_location, 1, GL_FALSE, glm::value_ptr(mvp));
+    glUniformMatrix4fv(mvp_location, 1, GL_FALSE, glm::value_ptr(model_mvp));
     glBindVertexArray(vao_);
-    glDrawElements(GL_TRIANGLES, vertices_count_, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, vertices_count_, index_type_, 0);
     glBindVertexArray(0);
 }
 
+size_t TMesh::triangleCount() const {
+    return vertices_count_ / 3;
+}
+
 }  // namespace
 
 static GLuint CreateShader(GLenum shader_type, const char* shader_program) {
@@ -151,66 +204,34 @@ GLuint CreateShaderProgram() {
     return shader_program;
 }
 
-std::unique_ptr<IMesh> CreatePlatformMesh() {
-    GLuint shader_program = CreateShaderProgram();
-
-    GLuint vao, vbo, ebo;
-
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        sizeof(kPlatformVertexData),
-        static_cast<const void*>(kPlatformVertexData),
-        GL_STATIC_DRAW
-    );
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        sizeof(kPlatformVertices),
-        static_cast<const void*>(kPlatformVertices),
-        GL_STATIC_DRAW
-    );
-
-    GLint vertex_location = glGetAttribLocation(shader_program, "position");
-    glVertexAttribPointer(
-        vertex_location,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(TMeshData),
-        reinterpret_cast<void*>(offsetof(TMeshData, position))
-    );
-    glEnableVertexAttribArray(vertex_location);
-    GLint colorLocation = glGetAttribLocation(shader_program, "color");
-    glVertexAttribPointer(
-        colorLocation,
-        4,
-        GL_FLOAT,
-        GL_TRUE,
-        sizeof(TMeshData),
-        reinterpret_cast<void*>(offsetof(TMeshData, color))
-    );
-    glEnableVertexAttribArray(colorLocation);
-
-    glBindVertexArray(0);
-
-    return std::make_unique<TMesh>(
-        vao,
-        shader_program,
-        sizeof(kPlatformVertices) / sizeof(*kPlatformVertices) * 3
-    );
+// NOTE: TMeshBuffers keeps GL names without including GL
+static_assert(std::is_same_v<GLuint, uint32_t>);
+
+TMeshSource PlatformMeshSource() {
+    // NOTE: static data, there is no storage to keep alive
+    return {
+        .layout =
+            {
+                .vertex_format = EMeshVertexFormat::FLOAT,
+                .index_type    = EMeshIndexType::UINT32,
+                .vertex_count  = std::size(kPlatformVertexData),
+                .index_count   = std::size(kPlatformVertices) * 3,
+            },
+        .vertices = std::as_bytes(std::span{kPlatformVertexData}),
+        .indices  = std::as_bytes(std::span{kPlatformVertices}),
+    };
 }
 
-static std::pair<std::vector<TMeshData>, std::vector<std::array<GLuint, 3>>>
-GenerateBallMeshData(float radius) {
-    std::vector<TMeshData> mesh_data;
-    std::vector<std ::array<GLuint, 3>> vertices;
+// NOTE: scratch data, freed once it is uploaded
+using TBallMeshData = std::pair<
+    std::pmr::vector<TMeshData>,
+    std::pmr::vector<std::array<GLuint, 3>>>;
+
+static TBallMeshData GenerateBallMeshData(
+    float radius, std::pmr::memory_resource* memory
+) {
+    std::pmr::vector<TMeshData> mesh_data{memory};
+    std::pmr::vector<std::array<GLuint, 3>> vertices{memory};
 
     static constexpr glm::vec3 kBaseSphereColor = {0.2f, 0.5f, 1.0f};
     static constexpr int kAngleStep             = 15;
@@ -297,63 +318,247 @@ GenerateBallMeshData(float radius) {
         };
     }
 
-    return std::make_pair(mesh_data, vertices);
+    return {std::move(mesh_data), std::move(vertices)};
 }
 
-std::unique_ptr<IMesh> CreateBallMesh() {
-    GLuint shader_program = CreateShaderProgram();
-
-    const auto& [sphereVertexData, sphereVertexIndices] =
-        GenerateBallMeshData(1.f);
-
-    GLuint vao, vbo, ebo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        sphereVertexData.size() * sizeof(*sphereVertexData.data()),
-        sphereVertexData.data(),
-        GL_STATIC_DRAW
-    );
+namespace {
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        sphereVertexIndices.size() * sizeof(*sphereVertexIndices.data()),
-        sphereVertexIndices.data(),
-        GL_STATIC_DRAW
-    );
+// NOTE: the arena goes after the data it holds
+struct TBallMeshStorage {
+    TLinearArena scratch;
+    std::optional<TBallMeshData> data;
+};
+
+}  // namespace
+
+TMeshSource BallMeshSource() {
+    // NOTE: enough for both arrays, anything larger falls back to the heap
+    static constexpr size_t kScratchSize = 16 * 1024;
+    auto storage                         = std::make_shared<TBallMeshStorage>();
+    storage->scratch.init(kScratchSize);
+    // NOTE: the moved vectors keep allocating from the arena
+    const auto& [vertices, indices] =
+        storage->data.emplace(GenerateBallMeshData(1.f, &storage->scratch));
+
+    return {
+        .layout =
+            {
+                .vertex_format = EMeshVertexFormat::FLOAT,
+                .index_type    = EMeshIndexType::UINT32,
+                .vertex_count  = vertices.size(),
+                .index_count   = indices.size() * 3,
+            },
+        .vertices = std::as_bytes(std::span{vertices}),
+        .indices  = std::as_bytes(std::span{indices}),
+        .storage  = std::move(storage),
+    };
+}
 
-    GLint vertex_location = glGetAttribLocation(shader_program, "position");
-    glVertexAttribPointer(
-        vertex_location,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(TMeshData),
-        reinterpret_cast<void*>(offsetof(TMeshData, position))
+static bool ValidateMeshAsset(
+    const TMeshAssetHeader& header, uint64_t file_size, const char** error
+) {
+    // NOTE: only the layout is checked, index values are trusted to keep
+    // loading free of passes over the data
+    auto fits = [file_size](uint64_t offset, uint64_t bytes) {
+        return offset % kMeshAssetAlignment == 0 && offset <= file_size &&
+               bytes <= file_size - offset;
+    };
+
+    if (header.magic != kMeshAssetMagic) {
+        *error = "not a cooked mesh";
+    } else if (header.version != kMeshAssetVersion) {
+        *error = "unsupported version, cook it again";
+    } else if (header.vertex_stride != sizeof(TMeshAssetVertex) ||
+               header.index_type >= EMeshIndexType::MESH_INDEX_TYPE_COUNT) {
+        *error = "unknown vertex or index format";
+    } else if (header.vertex_bytes !=
+                   uint64_t{header.vertex_count} * header.vertex_stride ||
+               header.index_bytes != uint64_t{header.index_count} *
+                                         MeshIndexSize(header.index_type) ||
+               header.index_count % 3 != 0 || !header.index_count) {
+        *error = "inconsistent sizes";
+    } else if (!fits(header.vertex_offset, header.vertex_bytes) ||
+               !fits(header.index_offset, header.index_bytes)) {
+        *error = "blobs are out of the file or misaligned";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+std::optional<TMeshSource> ReadMeshFile(
+    const std::string& path, bool prefault
+) {
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to open mesh " << path << ": "
+                  << std::strerror(errno) << std::endl;
+        return std::nullopt;
+    }
+
+    struct stat info;
+    void* file = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto flags = MAP_PRIVATE | (prefault ? MAP_POPULATE : 0);
+        file       = mmap(nullptr, info.st_size, PROT_READ, flags, fd, 0);
+    }
+    close(fd);
+    if (file == MAP_FAILED) {
+        std::cerr << "Failed to map mesh " << path << std::endl;
+        return std::nullopt;
+    }
+
+    size_t size = info.st_size;
+    auto unmap  = [size](const void* data) {
+        munmap(const_cast<void*>(data), size);
+    };
+    std::shared_ptr<const void> storage{file, unmap};
+
+    const char* error = "file is too small";
+    TMeshAssetHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, file, sizeof(header));
+        valid = ValidateMeshAsset(header, size, &error);
+    }
+    if (!valid) {
+        std::cerr << "Failed to load mesh " << path << ": " << error
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    auto* data = static_cast<const std::byte*>(file);
+    return TMeshSource{
+        .layout =
+            {
+                .vertex_format = EMeshVertexFormat::QUANTIZED,
+                .index_type    = header.index_type,
+                .vertex_count  = header.vertex_count,
+                .index_count   = header.index_count,
+                .bounds_min    = glm::make_vec3(header.bounds_min),
+                .bounds_max    = glm::make_vec3(header.bounds_max),
+            },
+        .vertices = {data + header.vertex_offset, header.vertex_bytes},
+        .indices  = {data + header.index_offset, header.index_bytes},
+        .storage  = std::move(storage),
+    };
+}
+
+TMeshBuffers UploadMeshSource(const TMeshSource& source) {
+    GACHIBALL_PROFILE_ZONE("mesh upload");
+    TMeshBuffers buffers{
+        .layout         = source.layout,
+        .shader_program = CreateShaderProgram(),
+        .buffer_bytes   = source.vertices.size() + source.indices.size(),
+    };
+
+    // NOTE: immutable storage is initialized straight from the source, a
+    // mapped file is copied by the driver without an intermediate buffer
+    glCreateBuffers(1, &buffers.vertex_buffer);
+    glNamedBufferStorage(
+        buffers.vertex_buffer,
+        source.vertices.size(),
+        source.vertices.data(),
+        0
     );
-    glEnableVertexAttribArray(vertex_location);
-    GLint colorLocation = glGetAttribLocation(shader_program, "color");
-    glVertexAttribPointer(
-        colorLocation,
-        4,
-        GL_FLOAT,
-        GL_TRUE,
-        sizeof(TMeshData),
-        reinterpret_cast<void*>(offsetof(TMeshData, color))
+    glCreateBuffers(1, &buffers.index_buffer);
+    glNamedBufferStorage(
+        buffers.index_buffer, source.indices.size(), source.indices.data(), 0
     );
-    glEnableVertexAttribArray(colorLocation);
+    return buffers;
+}
 
-    glBindVertexArray(0);
+std::unique_ptr<IMesh> CreateMesh(const TMeshBuffers& buffers) {
+    const auto& layout = buffers.layout;
+    auto quantized     = layout.vertex_format == EMeshVertexFormat::QUANTIZED;
+    auto stride        = quantized ? sizeof(TMeshAssetVertex)
+                                   : sizeof(TMeshData);
+
+    GLuint vao;
+    glCreateVertexArrays(1, &vao);
+    glVertexArrayVertexBuffer(vao, 0, buffers.vertex_buffer, 0, stride);
+    glVertexArrayElementBuffer(vao, buffers.index_buffer);
+
+    auto program          = buffers.shader_program;
+    GLint vertex_location = glGetAttribLocation(program, "position");
+    GLint color_location  = glGetAttribLocation(program, "color");
+    glEnableVertexArrayAttrib(vao, vertex_location);
+    glEnableVertexArrayAttrib(vao, color_location);
+    glVertexArrayAttribBinding(vao, vertex_location, 0);
+    glVertexArrayAttribBinding(vao, color_location, 0);
+
+    glm::mat4 dequantize{1.f};
+    if (quantized) {
+        glVertexArrayAttribFormat(
+            vao,
+            vertex_location,
+            3,
+            GL_SHORT,
+            GL_TRUE,
+            offsetof(TMeshAssetVertex, position)
+        );
+        glVertexArrayAttribFormat(
+            vao,
+            color_location,
+            4,
+            GL_UNSIGNED_BYTE,
+            GL_TRUE,
+            offsetof(TMeshAssetVertex, color)
+        );
+        dequantize = glm::scale(
+            glm::translate(
+                glm::mat4{1.f}, (layout.bounds_min + layout.bounds_max) * 0.5f
+            ),
+            (layout.bounds_max - layout.bounds_min) * 0.5f
+        );
+    } else {
+        glVertexArrayAttribFormat(
+            vao,
+            vertex_location,
+            3,
+            GL_FLOAT,
+            GL_FALSE,
+            offsetof(TMeshData, position)
+        );
+        glVertexArrayAttribFormat(
+            vao,
+            color_location,
+            4,
+            GL_FLOAT,
+            GL_FALSE,
+            offsetof(TMeshData, color)
+        );
+    }
 
     return std::make_unique<TMesh>(
-        vao, shader_program, sphereVertexIndices.size() * 3
+        vao,
+        program,
+        layout.index_count,
+        buffers.buffer_bytes,
+        layout.index_type == EMeshIndexType::UINT16 ? GL_UNSIGNED_SHORT
+                                                    : GL_UNSIGNED_INT,
+        dequantize
     );
 }
 
+std::unique_ptr<IMesh> CreateMesh(const TMeshSource& source) {
+    return CreateMesh(UploadMeshSource(source));
+}
+
+std::unique_ptr<IMesh> CreatePlatformMesh() {
+    return CreateMesh(PlatformMeshSource());
+}
+
+std::unique_ptr<IMesh> CreateBallMesh() {
+    return CreateMesh(BallMeshSource());
+}
+
+std::unique_ptr<IMesh> LoadMesh(const std::string& path) {
+    auto source = ReadMeshFile(path);
+    if (!source) {
+        return nullptr;
+    }
+    return CreateMesh(*source);
+}
+
 }  // namespace NGameEngine
@@ -0,0 +1,199 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr size_t kMetricCount =
+    static_cast<size_t>(EMetric::METRIC_COUNT);
+
+static constexpr std::array<std::string_view, kMetricCount> kMetricNames{
+    "frame_time_ms",
+    "physics_step_ms",
+    "draw_calls",
+    "triangles",
+    "events_dispatched",
+    "bodies_simulated",
+};
+
+static constexpr std::array<double, 3> kPercentiles{0.5, 0.9, 0.99};
+static constexpr std::array<std::string_view, 3> kPercentileNames{
+    "p50",
+    "p90",
+    "p99",
+};
+
+// NOTE: bucket values are approximate, keep them within the recorded range
+// so that e.g. an all zero interval reports zeros
+double Percentile(const THistogram& histogram, double p) {
+    return std::clamp(
+        histogram.percentile(p), histogram.min(), histogram.max()
+    );
+}
+
+// NOTE: fixed point numbers while alive, restores the format of the stream
+class TFixedFormat {
+  public:
+    explicit TFixedFormat(std::ostream& out)
+        : out_(out)
+        , flags_(out.flags())
+        , precision_(out.precision()) {
+        out_ << std::fixed << std::setprecision(3);
+    }
+
+    ~TFixedFormat() {
+        out_.flags(flags_);
+        out_.precision(precision_);
+    }
+
+  private:
+    std::ostream& out_;
+    std::ios_base::fmtflags flags_;
+    std::streamsize precision_;
+};
+
+}  // namespace
+
+TMetrics::TMetrics() {
+    // NOTE: timings use the default millisecond range, counts go up to a
+    // billion per frame
+    for (size_t i = 0; i < kMetricCount; ++i) {
+        auto metric = static_cast<EMetric>(i);
+        if (metric != EMetric::FRAME_TIME_MS &&
+            metric != EMetric::PHYSICS_STEP_MS) {
+            histograms_[i] = THistogram{1., 1e9};
+        }
+    }
+}
+
+void TMetrics::init(const TMetricsSettings& settings, double now) {
+    deinit();
+
+    settings_       = settings;
+    started_at_     = now;
+    interval_start_ = now;
+    if (!settings_.enabled) {
+        return;
+    }
+
+    out_ = &std::cout;
+    if (!settings_.path.empty()) {
+        file_.open(settings_.path);
+        if (!file_) {
+            std::cerr << "Failed to open metrics " << settings_.path
+                      << ", metrics are disabled" << std::endl;
+            return;
+        }
+        out_ = &file_;
+    }
+
+    enabled_            = true;
+    csv_header_written_ = false;
+}
+
+void TMetrics::deinit() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    out_     = nullptr;
+    enabled_ = false;
+    capture_ = false;
+    reset();
+}
+
+void TMetrics::record(EMetric metric, double value) {
+    if (enabled_ || capture_) {
+        histograms_[static_cast<size_t>(metric)].record(value);
+    }
+}
+
+void TMetrics::update(double now) {
+    if (!enabled_ || now - interval_start_ < settings_.period) {
+        return;
+    }
+
+    write(now);
+    reset();
+    interval_start_ = now;
+}
+
+void TMetrics::setCapture(bool capture) {
+    if (capture_ && !capture && !enabled_) {
+        reset();
+    }
+    capture_ = capture;
+}
+
+void TMetrics::snapshot(std::ostream& out, double now) const {
+    TFixedFormat format{out};
+    writeJson(out, now);
+}
+
+void TMetrics::reset() {
+    for (auto& histogram : histograms_) {
+        histogram.reset();
+    }
+}
+
+void TMetrics::write(double now) {
+    {
+        TFixedFormat format{*out_};
+        switch (settings_.format) {
+            case EMetricsFormat::CSV:
+                writeCsv(*out_, now);
+                break;
+            default:
+                writeJson(*out_, now);
+                break;
+        }
+    }
+    // NOTE: consumers tail the output, do not keep lines in the buffer
+    out_->flush();
+}
+
+void TMetrics::writeJson(std::ostream& out, double now) const {
+    out << "{\"time\":" << now - started_at_;
+    for (size_t i = 0; i < kMetricCount; ++i) {
+        const auto& histogram = histograms_[i];
+        out << ",\"" << kMetricNames[i]
+            << "\":{\"count\":" << histogram.count();
+        for (size_t j = 0; j < kPercentiles.size(); ++j) {
+            out << ",\"" << kPercentileNames[j]
+                << "\":" << Percentile(histogram, kPercentiles[j]);
+        }
+        out << ",\"max\":" << histogram.max() << "}";
+    }
+    out << "}\n";
+}
+
+void TMetrics::writeCsv(std::ostream& out, double now) {
+    if (!csv_header_written_) {
+        out << "time,metric,count";
+        for (auto name : kPercentileNames) {
+            out << "," << name;
+        }
+        out << ",max\n";
+        csv_header_written_ = true;
+    }
+
+    for (size_t i = 0; i < kMetricCount; ++i) {
+        const auto& histogram = histograms_[i];
+        out << now - started_at_ << "," << kMetricNames[i] << ","
+            << histogram.count();
+        for (auto p : kPercentiles) {
+            out << "," << Percentile(histogram, p);
+        }
+        out << "," << histogram.max() << "\n";
+    }
+}
+
+bool TMetrics::enabled() const {
+    return enabled_;
+}
+
+}  // namespace NGameEngine
@@ -1,49 +1,88 @@
 #include "physics_engine.hpp"
 
+#include "components.hpp"
+#include "profiler.hpp"
+
 namespace NGameEngine {
 
-void TPhysicsEngine::init(float simulation_step) {
+void TPhysicsEngine::init(float simulation_step, TTaskPool* task_pool) {
     spent_time_      = 0.f;
     simulation_step_ = simulation_step;
+    task_pool_       = task_pool;
 }
 
 void TPhysicsEngine::deinit() {
     spent_time_      = 0.f;
     simulation_step_ = 0.f;
-
-    bodies_.clear();
+    task_pool_       = nullptr;
 }
 
-void TPhysicsEngine::update(float dt) {
+bool TPhysicsEngine::update(float dt, TWorld* world) {
     spent_time_ += dt;
-    if (spent_time_ > simulation_step_) {
-        simulate(spent_time_);
-        spent_time_ = 0;
+    if (spent_time_ <= simulation_step_) {
+        return false;
     }
+
+    simulate(spent_time_, world);
+    spent_time_ = 0;
+    return true;
 }
 
-void TPhysicsEngine::addRigidBody(TRigidBody* body) {
-    bodies_.insert(body);
+void TPhysicsEngine::setSimulationStep(float simulation_step) {
+    simulation_step_ = simulation_step;
 }
 
-void TPhysicsEngine::simulate(float dt) {
-    moveBodies(dt);
-    applyForces(dt);
+float TPhysicsEngine::simulationStep() const {
+    return simulation_step_;
 }
 
-void TPhysicsEngine::moveBodies(float dt) {
-    for (auto* body : bodies_) {
-        body->position += body->velocity * dt;
-    }
+size_t TPhysicsEngine::simulatedBodies() const {
+    return simulated_bodies_;
+}
+
+void TPhysicsEngine::simulate(float dt, TWorld* world) {
+    GACHIBALL_PROFILE_ZONE("physics simulate");
+    moveBodies(dt, world);
+    applyForces(dt, world);
+}
+
+void TPhysicsEngine::moveBodies(float dt, TWorld* world) {
+    // NOTE: counted per table, cheaper than an atomic in the parallel loop
+    simulated_bodies_ = 0;
+    world->eachChunk<const TTransform, const TVelocity>(
+        [this](std::span<const TTransform> transforms, auto) {
+            simulated_bodies_ += transforms.size();
+        }
+    );
+
+    world->parallelEachChunk<TTransform, const TVelocity>(
+        task_pool_,
+        [dt](
+            std::span<TTransform> transforms,
+            std::span<const TVelocity> velocities
+        ) {
+            for (size_t i = 0; i < transforms.size(); ++i) {
+                transforms[i].position += velocities[i].linear * dt;
+            }
+        }
+    );
 }
 
-void TPhysicsEngine::applyForces(float dt) {
+void TPhysicsEngine::applyForces(float dt, TWorld* world) {
     static constexpr auto kG = 10.f * glm::vec3{0.f, -1.f, 0.f};
 
-    for (auto* body : bodies_) {
-        body->acceleration = body->mass * kG * body->mass_inv;
-        body->velocity += body->acceleration * dt;
-    }
+    world->parallelEachChunk<TVelocity, const TMass>(
+        task_pool_,
+        [dt](std::span<TVelocity> velocities, std::span<const TMass> masses) {
+            for (size_t i = 0; i < velocities.size(); ++i) {
+                const auto& mass = masses[i];
+                auto& velocity   = velocities[i];
+
+                velocity.acceleration = mass.mass * kG * mass.mass_inv;
+                velocity.linear += velocity.acceleration * dt;
+            }
+        }
+    );
 }
 
 }  // namespace NGameEngine
@@ -0,0 +1,200 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NGameEngine {
+
+namespace {
+
+static_assert(
+    (kProfileRingSize & (kProfileRingSize - 1)) == 0,
+    "ring size must be a power of two"
+);
+
+struct TProfileEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+// NOTE: single writer, the owning thread. Readers copy the window below
+// head and drop whatever the writer may have overwritten meanwhile.
+struct TProfileRing {
+    std::array<TProfileEvent, kProfileRingSize> events;
+    std::atomic<uint64_t> head{0};
+    uint32_t thread_id;
+    std::atomic<const char*> thread_name;
+};
+
+struct TProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TProfileRing>> rings;
+};
+
+std::atomic<bool> profiling_enabled{true};
+thread_local TProfileRing* thread_ring = nullptr;
+thread_local const char* thread_name   = nullptr;
+
+TProfileRegistry& Registry() {
+    static TProfileRegistry registry;
+    return registry;
+}
+
+uint64_t NowNs() {
+    using namespace std::chrono;
+    auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<nanoseconds>(now).count();
+}
+
+TProfileRing* ThreadRing() {
+    if (!thread_ring) {
+        // NOTE: rings are never freed, zones of exited threads stay
+        // exportable
+        auto ring      = std::make_unique<TProfileRing>();
+        auto& registry = Registry();
+        std::lock_guard lock{registry.mutex};
+        ring->thread_id   = static_cast<uint32_t>(registry.rings.size());
+        ring->thread_name = thread_name;
+        thread_ring       = ring.get();
+        registry.rings.push_back(std::move(ring));
+    }
+    return thread_ring;
+}
+
+void Record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+    auto* ring = ThreadRing();
+    auto head  = ring->head.load(std::memory_order_relaxed);
+    ring->events[head & (kProfileRingSize - 1)] = {name, begin_ns, end_ns};
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void WriteJsonString(std::ostream& out, const char* value) {
+    out << '"';
+    for (auto* c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+void SetProfilingEnabled(bool enabled) {
+    profiling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ProfilingEnabled() {
+    return profiling_enabled.load(std::memory_order_relaxed);
+}
+
+void SetProfileThreadName(const char* name) {
+    thread_name = name;
+    if (thread_ring) {
+        thread_ring->thread_name = name;
+    }
+}
+
+bool ExportChromeTrace(const std::string& path) {
+    struct TThreadEvents {
+        uint32_t thread_id;
+        const char* thread_name;
+        std::vector<TProfileEvent> events;
+    };
+
+    std::vector<TThreadEvents> threads;
+    {
+        auto& registry = Registry();
+        std::lock_guard lock{registry.mutex};
+        for (const auto& ring : registry.rings) {
+            auto end   = ring->head.load(std::memory_order_acquire);
+            auto begin = end > kProfileRingSize ? end - kProfileRingSize : 0;
+
+            TThreadEvents thread{ring->thread_id, ring->thread_name, {}};
+            thread.events.reserve(end - begin);
+            for (auto i = begin; i < end; ++i) {
+                thread.events.push_back(
+                    ring->events[i & (kProfileRingSize - 1)]
+                );
+            }
+
+            // NOTE: events are copied without synchronization while the
+            // owning thread may be writing them. Slots it has reused since,
+            // and the slot it may be writing now, at index head, hold torn
+            // copies of the oldest events and are dropped.
+            auto head = ring->head.load(std::memory_order_acquire);
+            if (head - begin >= kProfileRingSize) {
+                auto overwritten = std::min<uint64_t>(
+                    head + 1 - begin - kProfileRingSize, thread.events.size()
+                );
+                thread.events.erase(
+                    thread.events.begin(),
+                    thread.events.begin() + overwritten
+                );
+            }
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    uint64_t origin_ns = UINT64_MAX;
+    for (const auto& thread : threads) {
+        for (const auto& event : thread.events) {
+            origin_ns = std::min(origin_ns, event.begin_ns);
+        }
+    }
+
+    std::ofstream out{path};
+    if (!out) {
+        std::cerr << "Failed to open profile " << path << std::endl;
+        return false;
+    }
+
+    // NOTE: complete ("X") events, timestamps in microseconds
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& thread : threads) {
+        if (thread.thread_name) {
+            out << (first ? "\n" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << thread.thread_id << ",\"args\":{\"name\":";
+            WriteJsonString(out, thread.thread_name);
+            out << "}}";
+            first = false;
+        }
+        for (const auto& event : thread.events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            WriteJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.thread_id
+                << ",\"ts\":" << (event.begin_ns - origin_ns) / 1000.
+                << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.
+                << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return static_cast<bool>(out);
+}
+
+TProfileZone::TProfileZone(const char* name)
+    : name_(name)
+    , begin_ns_(ProfilingEnabled() ? NowNs() : 0) {
+}
+
+TProfileZone::~TProfileZone() {
+    if (begin_ns_) {
+        Record(name_, begin_ns_, NowNs());
+    }
+}
+
+}  // namespace NGameEngine
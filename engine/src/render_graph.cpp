@@ -0,0 +1,891 @@
+#include "render_graph.hpp"
+
+// clang-format off
+#include <glad/gl.h>
+// clang-format on
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "memory_tracker.hpp"
+#include "profiler.hpp"
+
+namespace NGameEngine {
+
+namespace {
+
+static constexpr size_t kNoPass = std::numeric_limits<size_t>::max();
+
+enum class EResourceKind {
+    TEXTURE,
+    BUFFER,
+    BACKBUFFER,
+};
+
+struct TAccess {
+    TRenderResource resource;
+    ERenderAccess access;
+};
+
+struct TResource {
+    std::string_view name;
+    EResourceKind kind;
+    TRenderTextureDesc texture_desc;
+    TRenderBufferDesc buffer_desc;
+
+    bool imported = false;
+    bool output   = false;
+    GLuint object = 0;
+
+    // NOTE: compiled state
+    size_t readers   = 0;
+    size_t first_use = kNoPass;
+    size_t last_use  = kNoPass;
+    size_t physical  = kNoPass;
+};
+
+struct TPass {
+    std::string_view name;
+    std::vector<TAccess> reads;
+    std::vector<TAccess> writes;
+    bool side_effect = false;
+    TRenderPassExecute execute;
+
+    // NOTE: compiled state
+    size_t writers_alive = 0;
+    bool culled          = false;
+    GLbitfield barriers  = 0;
+    GLuint framebuffer   = 0;
+};
+
+struct TPhysicalTexture {
+    TRenderTextureDesc desc;
+    GLuint texture = 0;
+    bool used      = false;
+};
+
+struct TPhysicalBuffer {
+    TRenderBufferDesc desc;
+    GLuint buffer = 0;
+    bool used     = false;
+};
+
+int64_t ByteSize(const TRenderTextureDesc& desc) {
+    return TextureByteSize(desc.format, desc.width, desc.height);
+}
+
+void DeleteTexture(const TPhysicalTexture& texture) {
+    glDeleteTextures(1, &texture.texture);
+    AddMemoryUsage(
+        EMemoryTag::RENDER, EMemoryPool::GPU, -ByteSize(texture.desc)
+    );
+}
+
+void DeleteBuffer(const TPhysicalBuffer& buffer) {
+    glDeleteBuffers(1, &buffer.buffer);
+    AddMemoryUsage(
+        EMemoryTag::RENDER,
+        EMemoryPool::GPU,
+        -static_cast<int64_t>(buffer.desc.size)
+    );
+}
+
+bool IsWriteAccess(ERenderAccess access) {
+    return access == ERenderAccess::COLOR_ATTACHMENT ||
+           access == ERenderAccess::DEPTH_ATTACHMENT ||
+           access == ERenderAccess::STORAGE ||
+           access == ERenderAccess::TRANSFER;
+}
+
+// NOTE: GL synchronizes everything except incoherent shader writes, so a
+// barrier is only needed after a STORAGE write, with bits of the next access
+GLbitfield BarrierAfterStorageWrite(ERenderAccess access, EResourceKind kind) {
+    switch (access) {
+        case ERenderAccess::COLOR_ATTACHMENT:
+        case ERenderAccess::DEPTH_ATTACHMENT:
+            return GL_FRAMEBUFFER_BARRIER_BIT;
+        case ERenderAccess::SAMPLED:
+            return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case ERenderAccess::STORAGE:
+            return kind == EResourceKind::BUFFER
+                     ? GL_SHADER_STORAGE_BARRIER_BIT
+                     : GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case ERenderAccess::TRANSFER:
+            return kind == EResourceKind::BUFFER
+                     ? GL_BUFFER_UPDATE_BARRIER_BIT
+                     : GL_TEXTURE_UPDATE_BARRIER_BIT |
+                           GL_FRAMEBUFFER_BARRIER_BIT;
+        case ERenderAccess::VERTEX_BUFFER:
+            return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                   GL_ELEMENT_ARRAY_BARRIER_BIT;
+        case ERenderAccess::UNIFORM_BUFFER:
+            return GL_UNIFORM_BARRIER_BIT;
+        default:
+            return 0;
+    }
+}
+
+}  // namespace
+
+class TRenderGraph::TImpl {
+  public:
+    TImpl(TGpuTimer* gpu_timer);
+    ~TImpl();
+
+    TRenderResource addResource(TResource resource);
+    TResource& resource(TRenderResource resource);
+    const TResource& resource(TRenderResource resource) const;
+
+    void addPass(
+        std::string_view name,
+        const TRenderPassSetup& setup,
+        TRenderPassExecute execute,
+        TRenderGraph* graph
+    );
+    void addAccess(size_t pass, TAccess access, bool write);
+    void markSideEffect(size_t pass);
+    void markDirty();
+
+    void compile();
+    void execute(const TRenderGraph* graph);
+
+    GLuint framebuffer(size_t pass) const;
+    GLuint object(TRenderResource resource) const;
+    GLuint readFramebuffer(TRenderResource resource) const;
+
+  public:
+    size_t activePassCount() const;
+    size_t culledPassCount() const;
+    size_t physicalTextureCount() const;
+    size_t physicalBufferCount() const;
+
+  private:
+    void resetCompiledState();
+    void cullPasses();
+    void orderPasses();
+    void computeLifetimes();
+    void allocatePhysical();
+    void computeBarriers();
+    void createFramebuffers();
+
+    size_t acquireTexture(const TRenderTextureDesc& desc);
+    size_t acquireBuffer(const TRenderBufferDesc& desc);
+    GLuint cachedFramebuffer(const std::vector<GLuint>& attachments) const;
+
+  private:
+    TGpuTimer* gpu_timer_;
+
+    std::vector<TResource> resources_;
+    std::vector<TPass> passes_;
+
+    bool dirty_ = true;
+    std::vector<size_t> order_;
+
+    std::vector<TPhysicalTexture> textures_;
+    std::vector<TPhysicalBuffer> buffers_;
+
+    // NOTE: key is color attachments followed by the depth attachment
+    mutable std::map<std::vector<GLuint>, GLuint> framebuffers_;
+};
+
+TRenderGraph::TImpl::TImpl(TGpuTimer* gpu_timer)
+    : gpu_timer_(gpu_timer) {
+    assert(gpu_timer_);
+}
+
+TRenderGraph::TImpl::~TImpl() {
+    for (const auto& [_, framebuffer] : framebuffers_) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    for (const auto& texture : textures_) {
+        DeleteTexture(texture);
+    }
+    for (const auto& buffer : buffers_) {
+        DeleteBuffer(buffer);
+    }
+}
+
+TRenderResource TRenderGraph::TImpl::addResource(TResource resource) {
+    resources_.push_back(std::move(resource));
+    markDirty();
+    return resources_.size() - 1;
+}
+
+TResource& TRenderGraph::TImpl::resource(TRenderResource resource) {
+    assert(resource < resources_.size());
+    return resources_[resource];
+}
+
+const TResource& TRenderGraph::TImpl::resource(TRenderResource resource
+) const {
+    assert(resource < resources_.size());
+    return resources_[resource];
+}
+
+void TRenderGraph::TImpl::addPass(
+    std::string_view name,
+    const TRenderPassSetup& setup,
+    TRenderPassExecute execute,
+    TRenderGraph* graph
+) {
+    passes_.push_back(TPass{
+        .name    = name,
+        .execute = std::move(execute),
+    });
+
+    TRenderPassBuilder builder{graph, passes_.size() - 1};
+    setup(builder);
+    markDirty();
+}
+
+void TRenderGraph::TImpl::addAccess(size_t pass, TAccess access, bool write) {
+    assert(pass < passes_.size());
+    assert(access.resource < resources_.size());
+    assert(!write || IsWriteAccess(access.access));
+
+    auto& accesses = write ? passes_[pass].writes : passes_[pass].reads;
+    accesses.push_back(access);
+}
+
+void TRenderGraph::TImpl::markSideEffect(size_t pass) {
+    passes_[pass].side_effect = true;
+}
+
+void TRenderGraph::TImpl::markDirty() {
+    dirty_ = true;
+}
+
+void TRenderGraph::TImpl::resetCompiledState() {
+    for (auto& resource : resources_) {
+        resource.readers   = 0;
+        resource.first_use = kNoPass;
+        resource.last_use  = kNoPass;
+        resource.physical  = kNoPass;
+    }
+    for (auto& pass : passes_) {
+        pass.writers_alive = pass.writes.size();
+        pass.culled        = false;
+        pass.barriers      = 0;
+        pass.framebuffer   = 0;
+    }
+    for (auto& texture : textures_) {
+        texture.used = false;
+    }
+    for (auto& buffer : buffers_) {
+        buffer.used = false;
+    }
+    order_.clear();
+}
+
+void TRenderGraph::TImpl::cullPasses() {
+    auto writes_resource = [](const TPass& pass, TRenderResource resource) {
+        return std::any_of(
+            pass.writes.begin(),
+            pass.writes.end(),
+            [resource](const auto& w) { return w.resource == resource; }
+        );
+    };
+
+    // NOTE: a pass without writes and side effects has no visible result
+    for (auto& pass : passes_) {
+        pass.culled = pass.writes.empty() && !pass.side_effect;
+    }
+
+    // NOTE: reading a resource you write yourself does not consume it
+    for (const auto& pass : passes_) {
+        if (pass.culled) {
+            continue;
+        }
+        for (const auto& read : pass.reads) {
+            if (!writes_resource(pass, read.resource)) {
+                ++resources_[read.resource].readers;
+            }
+        }
+    }
+
+    std::vector<TRenderResource> unused;
+    for (TRenderResource r = 0; r < resources_.size(); ++r) {
+        if (resources_[r].readers == 0 && !resources_[r].output) {
+            unused.push_back(r);
+        }
+    }
+
+    while (!unused.empty()) {
+        auto r = unused.back();
+        unused.pop_back();
+
+        for (auto& pass : passes_) {
+            if (pass.culled || pass.side_effect ||
+                !writes_resource(pass, r)) {
+                continue;
+            }
+            if (--pass.writers_alive > 0) {
+                continue;
+            }
+
+            pass.culled = true;
+            for (const auto& read : pass.reads) {
+                auto& resource = resources_[read.resource];
+                if (writes_resource(pass, read.resource)) {
+                    continue;
+                }
+                if (--resource.readers == 0 && !resource.output) {
+                    unused.push_back(read.resource);
+                }
+            }
+        }
+    }
+}
+
+void TRenderGraph::TImpl::orderPasses() {
+    // NOTE: a reader depends on the last writer declared before it, or on all
+    // writers if none was declared before. A writer depends on the writers
+    // declared before it and on the readers of those earlier versions.
+    std::vector<std::vector<size_t>> dependents(passes_.size());
+    std::vector<size_t> dependencies(passes_.size(), 0);
+
+    auto add_edge = [&](size_t from, size_t to) {
+        if (from == to || passes_[from].culled || passes_[to].culled) {
+            return;
+        }
+        auto& edges = dependents[from];
+        if (std::find(edges.begin(), edges.end(), to) == edges.end()) {
+            edges.push_back(to);
+            ++dependencies[to];
+        }
+    };
+
+    for (TRenderResource r = 0; r < resources_.size(); ++r) {
+        std::vector<size_t> writers;
+        std::vector<size_t> readers;
+        for (size_t p = 0; p < passes_.size(); ++p) {
+            const auto& pass = passes_[p];
+            auto uses        = [r](const auto& a) { return a.resource == r; };
+            if (std::any_of(pass.writes.begin(), pass.writes.end(), uses)) {
+                writers.push_back(p);
+            }
+            if (std::any_of(pass.reads.begin(), pass.reads.end(), uses)) {
+                readers.push_back(p);
+            }
+        }
+
+        for (auto reader : readers) {
+            auto it = std::lower_bound(writers.begin(), writers.end(), reader);
+            if (it != writers.begin()) {
+                add_edge(*std::prev(it), reader);
+            } else {
+                for (auto writer : writers) {
+                    add_edge(writer, reader);
+                }
+            }
+        }
+        for (auto writer : writers) {
+            for (auto other : writers) {
+                if (other < writer) {
+                    add_edge(other, writer);
+                }
+            }
+            for (auto reader : readers) {
+                if (reader < writer && writers.front() < reader) {
+                    add_edge(reader, writer);
+                }
+            }
+        }
+    }
+
+    // NOTE: Kahn's algorithm, ties are broken by declaration order
+    std::vector<size_t> ready;
+    size_t active = 0;
+    for (size_t p = 0; p < passes_.size(); ++p) {
+        if (passes_[p].culled) {
+            continue;
+        }
+        ++active;
+        if (dependencies[p] == 0) {
+            ready.push_back(p);
+        }
+    }
+
+    while (!ready.empty()) {
+        auto it = std::min_element(ready.begin(), ready.end());
+        auto p  = *it;
+        ready.erase(it);
+
+        order_.push_back(p);
+        for (auto dependent : dependents[p]) {
+            if (--dependencies[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+
+    if (order_.size() != active) {
+        std::cerr << "Render graph has a dependency cycle" << std::endl;
+        std::exit(7);
+    }
+}
+
+void TRenderGraph::TImpl::computeLifetimes() {
+    for (size_t i = 0; i < order_.size(); ++i) {
+        const auto& pass = passes_[order_[i]];
+        for (const auto* accesses : {&pass.reads, &pass.writes}) {
+            for (const auto& access : *accesses) {
+                auto& resource = resources_[access.resource];
+                if (resource.first_use == kNoPass) {
+                    resource.first_use = i;
+                }
+                resource.last_use = i;
+            }
+        }
+    }
+}
+
+size_t TRenderGraph::TImpl::acquireTexture(const TRenderTextureDesc& desc) {
+    for (size_t i = 0; i < textures_.size(); ++i) {
+        if (!textures_[i].used && textures_[i].desc == desc) {
+            textures_[i].used = true;
+            return i;
+        }
+    }
+
+    GLuint texture;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, desc.format, desc.width, desc.height);
+    AddMemoryUsage(EMemoryTag::RENDER, EMemoryPool::GPU, ByteSize(desc));
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    textures_.push_back({.desc = desc, .texture = texture, .used = true});
+    return textures_.size() - 1;
+}
+
+size_t TRenderGraph::TImpl::acquireBuffer(const TRenderBufferDesc& desc) {
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        if (!buffers_[i].used && buffers_[i].desc == desc) {
+            buffers_[i].used = true;
+            return i;
+        }
+    }
+
+    GLuint buffer;
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, desc.size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    AddMemoryUsage(EMemoryTag::RENDER, EMemoryPool::GPU, desc.size);
+
+    buffers_.push_back({.desc = desc, .buffer = buffer, .used = true});
+    return buffers_.size() - 1;
+}
+
+void TRenderGraph::TImpl::allocatePhysical() {
+    // NOTE: physical objects are released after the last use of a resource
+    // and may be picked up by a resource whose lifetime starts later
+    for (size_t i = 0; i < order_.size(); ++i) {
+        for (auto& resource : resources_) {
+            if (resource.imported || resource.first_use != i) {
+                continue;
+            }
+            resource.physical = resource.kind == EResourceKind::TEXTURE
+                                  ? acquireTexture(resource.texture_desc)
+                                  : acquireBuffer(resource.buffer_desc);
+        }
+        for (auto& resource : resources_) {
+            if (resource.imported || resource.last_use != i) {
+                continue;
+            }
+            if (resource.kind == EResourceKind::TEXTURE) {
+                textures_[resource.physical].used = false;
+            } else {
+                buffers_[resource.physical].used = false;
+            }
+        }
+    }
+
+    // NOTE: mark what is referenced and drop the rest to keep VRAM down
+    std::vector<bool> texture_alive(textures_.size(), false);
+    std::vector<bool> buffer_alive(buffers_.size(), false);
+    for (const auto& resource : resources_) {
+        if (resource.imported || resource.physical == kNoPass) {
+            continue;
+        }
+        auto& alive = resource.kind == EResourceKind::TEXTURE ? texture_alive
+                                                              : buffer_alive;
+        alive[resource.physical] = true;
+    }
+
+    std::vector<size_t> texture_remap(textures_.size(), kNoPass);
+    std::vector<TPhysicalTexture> textures;
+    for (size_t i = 0; i < textures_.size(); ++i) {
+        if (texture_alive[i]) {
+            texture_remap[i] = textures.size();
+            textures.push_back(textures_[i]);
+        } else {
+            DeleteTexture(textures_[i]);
+        }
+    }
+    std::vector<size_t> buffer_remap(buffers_.size(), kNoPass);
+    std::vector<TPhysicalBuffer> buffers;
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        if (buffer_alive[i]) {
+            buffer_remap[i] = buffers.size();
+            buffers.push_back(buffers_[i]);
+        } else {
+            DeleteBuffer(buffers_[i]);
+        }
+    }
+    textures_ = std::move(textures);
+    buffers_  = std::move(buffers);
+
+    for (auto& resource : resources_) {
+        if (resource.imported || resource.physical == kNoPass) {
+            continue;
+        }
+        resource.physical = resource.kind == EResourceKind::TEXTURE
+                              ? texture_remap[resource.physical]
+                              : buffer_remap[resource.physical];
+    }
+}
+
+void TRenderGraph::TImpl::computeBarriers() {
+    // NOTE: tracked per GL object, aliased resources share the hazard
+    std::map<GLuint, bool> storage_written;
+
+    for (auto p : order_) {
+        auto& pass = passes_[p];
+        for (const auto* accesses : {&pass.reads, &pass.writes}) {
+            for (const auto& access : *accesses) {
+                const auto& resource = resources_[access.resource];
+                auto it = storage_written.find(object(access.resource));
+                if (it != storage_written.end() && it->second) {
+                    pass.barriers |=
+                        BarrierAfterStorageWrite(access.access, resource.kind);
+                }
+            }
+        }
+        for (const auto& access : pass.reads) {
+            storage_written[object(access.resource)] = false;
+        }
+        for (const auto& access : pass.writes) {
+            storage_written[object(access.resource)] =
+                access.access == ERenderAccess::STORAGE;
+        }
+    }
+}
+
+GLuint TRenderGraph::TImpl::cachedFramebuffer(
+    const std::vector<GLuint>& attachments
+) const {
+    if (auto it = framebuffers_.find(attachments); it != framebuffers_.end()) {
+        return it->second;
+    }
+
+    GLuint framebuffer;
+    glCreateFramebuffers(1, &framebuffer);
+
+    std::vector<GLenum> draw_buffers;
+    for (size_t i = 0; i + 1 < attachments.size(); ++i) {
+        auto attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        glNamedFramebufferTexture(framebuffer, attachment, attachments[i], 0);
+        draw_buffers.push_back(attachment);
+    }
+    if (attachments.back()) {
+        glNamedFramebufferTexture(
+            framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, attachments.back(), 0
+        );
+    }
+    glNamedFramebufferDrawBuffers(
+        framebuffer, draw_buffers.size(), draw_buffers.data()
+    );
+    if (!draw_buffers.empty()) {
+        glNamedFramebufferReadBuffer(framebuffer, GL_COLOR_ATTACHMENT0);
+    }
+
+    if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) !=
+        GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Render graph framebuffer is incomplete" << std::endl;
+        std::exit(6);
+    }
+
+    framebuffers_.emplace(attachments, framebuffer);
+    return framebuffer;
+}
+
+void TRenderGraph::TImpl::createFramebuffers() {
+    // NOTE: cached attachments may reference deleted objects
+    for (const auto& [_, framebuffer] : framebuffers_) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    framebuffers_.clear();
+
+    for (auto p : order_) {
+        auto& pass = passes_[p];
+
+        std::vector<GLuint> attachments;
+        GLuint depth    = 0;
+        bool backbuffer = false;
+        for (const auto& access : pass.writes) {
+            if (resources_[access.resource].kind == EResourceKind::BACKBUFFER) {
+                backbuffer = true;
+            } else if (access.access == ERenderAccess::COLOR_ATTACHMENT) {
+                attachments.push_back(object(access.resource));
+            } else if (access.access == ERenderAccess::DEPTH_ATTACHMENT) {
+                depth = object(access.resource);
+            }
+        }
+
+        if (backbuffer || (attachments.empty() && !depth)) {
+            pass.framebuffer = 0;
+            continue;
+        }
+        attachments.push_back(depth);
+        pass.framebuffer = cachedFramebuffer(attachments);
+    }
+}
+
+void TRenderGraph::TImpl::compile() {
+    resetCompiledState();
+    cullPasses();
+    orderPasses();
+    computeLifetimes();
+    allocatePhysical();
+    computeBarriers();
+    createFramebuffers();
+
+    dirty_ = false;
+}
+
+void TRenderGraph::TImpl::execute(const TRenderGraph* graph) {
+    GACHIBALL_PROFILE_ZONE("render graph");
+    if (dirty_) {
+        compile();
+    }
+
+    for (auto p : order_) {
+        const auto& pass = passes_[p];
+        TGpuTimerScope scope{gpu_timer_, pass.name};
+
+        if (pass.barriers) {
+            glMemoryBarrier(pass.barriers);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+        pass.execute(TRenderPassContext{graph, p});
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint TRenderGraph::TImpl::framebuffer(size_t pass) const {
+    return passes_[pass].framebuffer;
+}
+
+GLuint TRenderGraph::TImpl::object(TRenderResource r) const {
+    const auto& res = resource(r);
+    if (res.imported) {
+        return res.object;
+    }
+    if (res.physical == kNoPass) {
+        return 0;
+    }
+    return res.kind == EResourceKind::TEXTURE ? textures_[res.physical].texture
+                                              : buffers_[res.physical].buffer;
+}
+
+GLuint TRenderGraph::TImpl::readFramebuffer(TRenderResource r) const {
+    if (resource(r).kind == EResourceKind::BACKBUFFER) {
+        return 0;
+    }
+    return cachedFramebuffer({object(r), 0});
+}
+
+size_t TRenderGraph::TImpl::activePassCount() const {
+    return order_.size();
+}
+
+size_t TRenderGraph::TImpl::culledPassCount() const {
+    return std::count_if(passes_.begin(), passes_.end(), [](const auto& p) {
+        return p.culled;
+    });
+}
+
+size_t TRenderGraph::TImpl::physicalTextureCount() const {
+    return textures_.size();
+}
+
+size_t TRenderGraph::TImpl::physicalBufferCount() const {
+    return buffers_.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TRenderPassBuilder and TRenderPassContext
+///////////////////////////////////////////////////////////////////////////////
+
+TRenderPassBuilder::TRenderPassBuilder(TRenderGraph* graph, size_t pass)
+    : graph_(graph), pass_(pass) {
+}
+
+void TRenderPassBuilder::read(TRenderResource resource, ERenderAccess access) {
+    graph_->impl_->addAccess(pass_, {resource, access}, false);
+}
+
+void TRenderPassBuilder::write(TRenderResource resource, ERenderAccess access) {
+    graph_->impl_->addAccess(pass_, {resource, access}, true);
+}
+
+void TRenderPassBuilder::markSideEffect() {
+    graph_->impl_->markSideEffect(pass_);
+}
+
+TRenderPassContext::TRenderPassContext(const TRenderGraph* graph, size_t pass)
+    : graph_(graph), pass_(pass) {
+}
+
+uint32_t TRenderPassContext::framebuffer() const {
+    return graph_->impl_->framebuffer(pass_);
+}
+
+uint32_t TRenderPassContext::texture(TRenderResource resource) const {
+    return graph_->impl_->object(resource);
+}
+
+uint32_t TRenderPassContext::buffer(TRenderResource resource) const {
+    return graph_->impl_->object(resource);
+}
+
+uint32_t TRenderPassContext::readFramebuffer(TRenderResource resource) const {
+    return graph_->impl_->readFramebuffer(resource);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TRenderGraph
+///////////////////////////////////////////////////////////////////////////////
+
+TRenderGraph::TRenderGraph() {
+}
+
+TRenderGraph::~TRenderGraph() {
+}
+
+void TRenderGraph::init(TGpuTimer* gpu_timer) {
+    assert(!impl_);
+
+    impl_ = std::make_unique<TImpl>(gpu_timer);
+}
+
+void TRenderGraph::deinit() {
+    impl_.reset();
+}
+
+TRenderResource TRenderGraph::createTexture(
+    std::string_view name, const TRenderTextureDesc& desc
+) {
+    return impl_->addResource(TResource{
+        .name         = name,
+        .kind         = EResourceKind::TEXTURE,
+        .texture_desc = desc,
+    });
+}
+
+TRenderResource TRenderGraph::createBuffer(
+    std::string_view name, const TRenderBufferDesc& desc
+) {
+    return impl_->addResource(TResource{
+        .name        = name,
+        .kind        = EResourceKind::BUFFER,
+        .buffer_desc = desc,
+    });
+}
+
+TRenderResource TRenderGraph::importTexture(
+    std::string_view name, uint32_t texture, const TRenderTextureDesc& desc
+) {
+    return impl_->addResource(TResource{
+        .name         = name,
+        .kind         = EResourceKind::TEXTURE,
+        .texture_desc = desc,
+        .imported     = true,
+        .object       = texture,
+    });
+}
+
+TRenderResource TRenderGraph::importBuffer(
+    std::string_view name, uint32_t buffer, const TRenderBufferDesc& desc
+) {
+    return impl_->addResource(TResource{
+        .name        = name,
+        .kind        = EResourceKind::BUFFER,
+        .buffer_desc = desc,
+        .imported    = true,
+        .object      = buffer,
+    });
+}
+
+TRenderResource TRenderGraph::importBackbuffer(std::string_view name) {
+    return impl_->addResource(TResource{
+        .name     = name,
+        .kind     = EResourceKind::BACKBUFFER,
+        .imported = true,
+        .output   = true,
+    });
+}
+
+void TRenderGraph::markOutput(TRenderResource resource) {
+    impl_->resource(resource).output = true;
+    impl_->markDirty();
+}
+
+void TRenderGraph::setTextureDesc(
+    TRenderResource resource, const TRenderTextureDesc& desc
+) {
+    auto& res = impl_->resource(resource);
+    if (res.texture_desc != desc) {
+        res.texture_desc = desc;
+        impl_->markDirty();
+    }
+}
+
+void TRenderGraph::setBufferDesc(
+    TRenderResource resource, const TRenderBufferDesc& desc
+) {
+    auto& res = impl_->resource(resource);
+    if (res.buffer_desc != desc) {
+        res.buffer_desc = desc;
+        impl_->markDirty();
+    }
+}
+
+void TRenderGraph::addPass(
+    std::string_view name,
+    const TRenderPassSetup& setup,
+    TRenderPassExecute execute
+) {
+    impl_->addPass(name, setup, std::move(execute), this);
+}
+
+void TRenderGraph::compile() {
+    impl_->compile();
+}
+
+void TRenderGraph::execute() {
+    impl_->execute(this);
+}
+
+size_t TRenderGraph::activePassCount() const {
+    return impl_->activePassCount();
+}
+
+size_t TRenderGraph::culledPassCount() const {
+    return impl_->culledPassCount();
+}
+
+size_t TRenderGraph::physicalTextureCount() const {
+    return impl_->physicalTextureCount();
+}
+
+size_t TRenderGraph::physicalBufferCount() const {
+    return impl_->physicalBufferCount();
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,208 @@
+#include "scene_graph.hpp"
+
+#include <cassert>
+
+#include "memory_tracker.hpp"
+#include "transform_batch.hpp"
+
+namespace NGameEngine {
+
+TSceneNode TSceneGraph::createNode(TSceneNode parent) {
+    TSceneNode node;
+    if (!free_nodes_.empty()) {
+        node = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        node = static_cast<TSceneNode>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    nodes_[node] = TNode{
+        .position     = glm::vec3{0.f},
+        .rotation     = glm::quat{1.f, 0.f, 0.f, 0.f},
+        .local        = glm::mat4{1.f},
+        .world        = glm::mat4{1.f},
+        .parent       = kInvalidSceneNode,
+        .first_child  = kInvalidSceneNode,
+        .next_sibling = kInvalidSceneNode,
+        .prev_sibling = kInvalidSceneNode,
+        .alive        = true,
+        .dirty        = false,
+        .child_dirty  = false,
+    };
+    ++node_count_;
+
+    link(node, parent);
+    markDirty(node);
+    return node;
+}
+
+void TSceneGraph::destroyNode(TSceneNode node) {
+    assert(node < nodes_.size() && nodes_[node].alive);
+
+    while (nodes_[node].first_child != kInvalidSceneNode) {
+        setParent(nodes_[node].first_child, kInvalidSceneNode);
+    }
+    unlink(node);
+
+    nodes_[node].alive = false;
+    free_nodes_.push_back(node);
+    --node_count_;
+}
+
+void TSceneGraph::setParent(TSceneNode node, TSceneNode parent) {
+    assert(node < nodes_.size() && nodes_[node].alive);
+
+    unlink(node);
+    link(node, parent);
+    markDirty(node);
+}
+
+void TSceneGraph::setLocalTransform(
+    TSceneNode node, const glm::vec3& position, const glm::quat& rotation
+) {
+    assert(node < nodes_.size() && nodes_[node].alive);
+
+    auto& n = nodes_[node];
+    if (n.position == position && n.rotation == rotation) {
+        return;
+    }
+    n.position = position;
+    n.rotation = rotation;
+    markDirty(node);
+}
+
+void TSceneGraph::link(TSceneNode node, TSceneNode parent) {
+    auto& n  = nodes_[node];
+    n.parent = parent;
+
+    auto& head =
+        parent == kInvalidSceneNode ? first_root_ : nodes_[parent].first_child;
+    n.prev_sibling = kInvalidSceneNode;
+    n.next_sibling = head;
+    if (head != kInvalidSceneNode) {
+        nodes_[head].prev_sibling = node;
+    }
+    head = node;
+}
+
+void TSceneGraph::unlink(TSceneNode node) {
+    auto& n = nodes_[node];
+    if (n.prev_sibling != kInvalidSceneNode) {
+        nodes_[n.prev_sibling].next_sibling = n.next_sibling;
+    } else if (n.parent != kInvalidSceneNode) {
+        nodes_[n.parent].first_child = n.next_sibling;
+    } else {
+        first_root_ = n.next_sibling;
+    }
+    if (n.next_sibling != kInvalidSceneNode) {
+        nodes_[n.next_sibling].prev_sibling = n.prev_sibling;
+    }
+
+    n.parent       = kInvalidSceneNode;
+    n.next_sibling = kInvalidSceneNode;
+    n.prev_sibling = kInvalidSceneNode;
+}
+
+void TSceneGraph::markDirty(TSceneNode node) {
+    if (!nodes_[node].dirty) {
+        nodes_[node].dirty = true;
+        dirty_nodes_.push_back(node);
+    }
+
+    // NOTE: stop at the first ancestor which is already flagged
+    for (auto p = nodes_[node].parent;
+         p != kInvalidSceneNode && !nodes_[p].child_dirty;
+         p = nodes_[p].parent) {
+        nodes_[p].child_dirty = true;
+    }
+}
+
+void TSceneGraph::rebuildLocalMatrices() {
+    // NOTE: destroyed nodes may still be listed, their matrices are unused
+    batch_positions_.clear();
+    batch_rotations_.clear();
+    for (auto node : dirty_nodes_) {
+        batch_positions_.push_back(nodes_[node].position);
+        batch_rotations_.push_back(nodes_[node].rotation);
+    }
+
+    batch_locals_.resize(dirty_nodes_.size());
+    BuildModelMatrices(
+        batch_positions_.data(),
+        batch_rotations_.data(),
+        dirty_nodes_.size(),
+        batch_locals_.data()
+    );
+
+    for (size_t i = 0; i < dirty_nodes_.size(); ++i) {
+        nodes_[dirty_nodes_[i]].local = batch_locals_[i];
+    }
+    dirty_nodes_.clear();
+}
+
+size_t TSceneGraph::update() {
+    size_t updated = 0;
+
+    rebuildLocalMatrices();
+
+    stack_.clear();
+    for (auto root = first_root_; root != kInvalidSceneNode;
+         root      = nodes_[root].next_sibling) {
+        if (nodes_[root].dirty || nodes_[root].child_dirty) {
+            stack_.emplace_back(root, false);
+        }
+    }
+
+    while (!stack_.empty()) {
+        auto [node, parent_changed] = stack_.back();
+        stack_.pop_back();
+
+        auto& n      = nodes_[node];
+        bool changed = n.dirty || parent_changed;
+        if (changed) {
+            n.world = n.parent == kInvalidSceneNode
+                        ? n.local
+                        : nodes_[n.parent].world * n.local;
+            ++updated;
+        }
+
+        if (changed || n.child_dirty) {
+            for (auto child = n.first_child; child != kInvalidSceneNode;
+                 child      = nodes_[child].next_sibling) {
+                const auto& c = nodes_[child];
+                if (changed || c.dirty || c.child_dirty) {
+                    stack_.emplace_back(child, changed);
+                }
+            }
+        }
+
+        n.dirty       = false;
+        n.child_dirty = false;
+    }
+
+    return updated;
+}
+
+const glm::mat4& TSceneGraph::localMatrix(TSceneNode node) const {
+    assert(node < nodes_.size() && nodes_[node].alive);
+    return nodes_[node].local;
+}
+
+const glm::mat4& TSceneGraph::worldMatrix(TSceneNode node) const {
+    assert(node < nodes_.size() && nodes_[node].alive);
+    return nodes_[node].world;
+}
+
+size_t TSceneGraph::nodeCount() const {
+    return node_count_;
+}
+
+size_t TSceneGraph::memoryUsage() const {
+    return CapacityBytes(nodes_) + CapacityBytes(free_nodes_) +
+           CapacityBytes(dirty_nodes_) + CapacityBytes(stack_) +
+           CapacityBytes(batch_positions_) + CapacityBytes(batch_rotations_) +
+           CapacityBytes(batch_locals_);
+}
+
+}  // namespace NGameEngine
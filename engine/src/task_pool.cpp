@@ -0,0 +1,104 @@
+#include "task_pool.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+namespace NGameEngine {
+
+TTaskPool::~TTaskPool() {
+    deinit();
+}
+
+void TTaskPool::init(int worker_count) {
+    deinit();
+
+    if (worker_count < 0) {
+        auto threads = static_cast<int>(std::thread::hardware_concurrency());
+        worker_count = std::max(threads - 1, 0);
+    }
+
+    stop_ = false;
+    workers_.reserve(worker_count);
+    for (int i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+void TTaskPool::deinit() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    job_ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void TTaskPool::run(size_t count, TJobFunc func, void* context) {
+    if (workers_.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(context, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock{mutex_};
+        func_    = func;
+        context_ = context;
+        count_   = count;
+        next_index_.store(0, std::memory_order_relaxed);
+        busy_workers_ = workers_.size();
+        ++job_;
+    }
+    job_ready_.notify_all();
+
+    work();
+
+    // NOTE: the job lives on the caller stack, every worker must be done
+    // with it, not only with its indices
+    std::unique_lock lock{mutex_};
+    job_done_.wait(lock, [this] { return busy_workers_ == 0; });
+}
+
+void TTaskPool::work() {
+    GACHIBALL_PROFILE_ZONE("task pool job");
+    for (auto i = next_index_.fetch_add(1, std::memory_order_relaxed);
+         i < count_;
+         i = next_index_.fetch_add(1, std::memory_order_relaxed)) {
+        func_(context_, i);
+    }
+}
+
+void TTaskPool::workerLoop() {
+    SetProfileThreadName("worker");
+    uint64_t seen_job = 0;
+    for (;;) {
+        {
+            std::unique_lock lock{mutex_};
+            job_ready_.wait(lock, [&] { return stop_ || job_ != seen_job; });
+            if (stop_) {
+                return;
+            }
+            seen_job = job_;
+        }
+
+        work();
+
+        {
+            std::lock_guard lock{mutex_};
+            --busy_workers_;
+        }
+        job_done_.notify_one();
+    }
+}
+
+size_t TTaskPool::workerCount() const {
+    return workers_.size();
+}
+
+}  // namespace NGameEngine
@@ -0,0 +1,440 @@
+#include "transform_batch.hpp"
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define GACHIBALL_TRANSFORM_SSE 1
+#endif
+
+#if defined(GACHIBALL_TRANSFORM_SSE) && defined(__AVX2__)
+#define GACHIBALL_TRANSFORM_AVX2 1
+#endif
+
+namespace NGameEngine {
+
+// NOTE: kernels read glm types as plain float arrays
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+static_assert(sizeof(glm::quat) == 4 * sizeof(float));
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float));
+static_assert(offsetof(glm::quat, x) == 0 * sizeof(float));
+static_assert(offsetof(glm::quat, w) == 3 * sizeof(float));
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Scalar path
+///////////////////////////////////////////////////////////////////////////////
+
+void BuildModelScalar(const glm::vec3& p, const glm::quat& q, glm::mat4& m) {
+    float x2 = q.x + q.x;
+    float y2 = q.y + q.y;
+    float z2 = q.z + q.z;
+
+    float xx = q.x * x2;
+    float yy = q.y * y2;
+    float zz = q.z * z2;
+    float xy = q.x * y2;
+    float xz = q.x * z2;
+    float yz = q.y * z2;
+    float wx = q.w * x2;
+    float wy = q.w * y2;
+    float wz = q.w * z2;
+
+    m[0] = glm::vec4(1.f - (yy + zz), xy + wz, xz - wy, 0.f);
+    m[1] = glm::vec4(xy - wz, 1.f - (xx + zz), yz + wx, 0.f);
+    m[2] = glm::vec4(xz + wy, yz - wx, 1.f - (xx + yy), 0.f);
+    m[3] = glm::vec4(p, 1.f);
+}
+
+void BuildScalar(
+    const glm::mat4* vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    for (size_t i = 0; i < count; ++i) {
+        BuildModelScalar(positions[i], rotations[i], models[i]);
+        if (vp) {
+            mvps[i] = *vp * models[i];
+        }
+    }
+}
+
+#if defined(GACHIBALL_TRANSFORM_SSE)
+
+///////////////////////////////////////////////////////////////////////////////
+// SIMD path
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: structure of arrays, one lane per body. Model is affine, so only the
+// upper three rows of every column are computed.
+template <typename TOps>
+struct TSoaTransform {
+    using V = typename TOps::V;
+
+    V model[4][3];
+    V mvp[4][4];
+};
+
+template <typename TOps>
+void ComputeModel(
+    const typename TOps::V (&q)[4],
+    const typename TOps::V (&p)[3],
+    TSoaTransform<TOps>& t
+) {
+    using V = typename TOps::V;
+
+    V x2 = TOps::Add(q[0], q[0]);
+    V y2 = TOps::Add(q[1], q[1]);
+    V z2 = TOps::Add(q[2], q[2]);
+
+    V xx = TOps::Mul(q[0], x2);
+    V yy = TOps::Mul(q[1], y2);
+    V zz = TOps::Mul(q[2], z2);
+    V xy = TOps::Mul(q[0], y2);
+    V xz = TOps::Mul(q[0], z2);
+    V yz = TOps::Mul(q[1], z2);
+    V wx = TOps::Mul(q[3], x2);
+    V wy = TOps::Mul(q[3], y2);
+    V wz = TOps::Mul(q[3], z2);
+
+    V one = TOps::Set1(1.f);
+
+    t.model[0][0] = TOps::Sub(one, TOps::Add(yy, zz));
+    t.model[0][1] = TOps::Add(xy, wz);
+    t.model[0][2] = TOps::Sub(xz, wy);
+
+    t.model[1][0] = TOps::Sub(xy, wz);
+    t.model[1][1] = TOps::Sub(one, TOps::Add(xx, zz));
+    t.model[1][2] = TOps::Add(yz, wx);
+
+    t.model[2][0] = TOps::Add(xz, wy);
+    t.model[2][1] = TOps::Sub(yz, wx);
+    t.model[2][2] = TOps::Sub(one, TOps::Add(xx, yy));
+
+    t.model[3][0] = p[0];
+    t.model[3][1] = p[1];
+    t.model[3][2] = p[2];
+}
+
+template <typename TOps>
+void ComputeMvp(const glm::mat4& vp, TSoaTransform<TOps>& t) {
+    // NOTE: mvp[j][r] = sum_k vp[k][r] * model[j][k], model[j][3] is 0 for
+    // the rotation columns and 1 for the translation
+    for (int r = 0; r < 4; ++r) {
+        auto vp0 = TOps::Set1(vp[0][r]);
+        auto vp1 = TOps::Set1(vp[1][r]);
+        auto vp2 = TOps::Set1(vp[2][r]);
+        auto vp3 = TOps::Set1(vp[3][r]);
+
+        for (int j = 0; j < 4; ++j) {
+            auto acc = j == 3 ? vp3 : TOps::Set1(0.f);
+            acc      = TOps::MulAdd(vp0, t.model[j][0], acc);
+            acc      = TOps::MulAdd(vp1, t.model[j][1], acc);
+            acc      = TOps::MulAdd(vp2, t.model[j][2], acc);
+
+            t.mvp[j][r] = acc;
+        }
+    }
+}
+
+struct TSseOps {
+    using V = __m128;
+
+    static V Set1(float value) {
+        return _mm_set1_ps(value);
+    }
+    static V Add(V a, V b) {
+        return _mm_add_ps(a, b);
+    }
+    static V Sub(V a, V b) {
+        return _mm_sub_ps(a, b);
+    }
+    static V Mul(V a, V b) {
+        return _mm_mul_ps(a, b);
+    }
+    static V MulAdd(V a, V b, V c) {
+#if defined(__FMA__)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+};
+
+void LoadSoa4(
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    __m128 (&q)[4],
+    __m128 (&p)[3]
+) {
+    q[0] = _mm_loadu_ps(&rotations[0].x);
+    q[1] = _mm_loadu_ps(&rotations[1].x);
+    q[2] = _mm_loadu_ps(&rotations[2].x);
+    q[3] = _mm_loadu_ps(&rotations[3].x);
+    _MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+
+    p[0] = _mm_setr_ps(
+        positions[0].x, positions[1].x, positions[2].x, positions[3].x
+    );
+    p[1] = _mm_setr_ps(
+        positions[0].y, positions[1].y, positions[2].y, positions[3].y
+    );
+    p[2] = _mm_setr_ps(
+        positions[0].z, positions[1].z, positions[2].z, positions[3].z
+    );
+}
+
+// NOTE: columns[c][r] holds element (c, r) of 4 matrices
+void StoreAos4(__m128 (&columns)[4][4], glm::mat4* out) {
+    for (int c = 0; c < 4; ++c) {
+        _MM_TRANSPOSE4_PS(
+            columns[c][0], columns[c][1], columns[c][2], columns[c][3]
+        );
+        for (int l = 0; l < 4; ++l) {
+            _mm_storeu_ps(&out[l][c][0], columns[c][l]);
+        }
+    }
+}
+
+void StoreSoa4(
+    const __m128 (&model)[4][3],
+    const __m128 (&mvp)[4][4],
+    bool with_mvp,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    __m128 columns[4][4];
+    for (int c = 0; c < 4; ++c) {
+        columns[c][0] = model[c][0];
+        columns[c][1] = model[c][1];
+        columns[c][2] = model[c][2];
+        columns[c][3] = _mm_set1_ps(c == 3 ? 1.f : 0.f);
+    }
+    StoreAos4(columns, models);
+
+    if (with_mvp) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                columns[c][r] = mvp[c][r];
+            }
+        }
+        StoreAos4(columns, mvps);
+    }
+}
+
+size_t BuildSse(
+    const glm::mat4* vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 q[4];
+        __m128 p[3];
+        LoadSoa4(positions + i, rotations + i, q, p);
+
+        TSoaTransform<TSseOps> t;
+        ComputeModel<TSseOps>(q, p, t);
+        if (vp) {
+            ComputeMvp<TSseOps>(*vp, t);
+        }
+        StoreSoa4(
+            t.model, t.mvp, vp != nullptr, models + i, vp ? mvps + i : nullptr
+        );
+    }
+    return i;
+}
+
+#if defined(GACHIBALL_TRANSFORM_AVX2)
+
+struct TAvxOps {
+    using V = __m256;
+
+    static V Set1(float value) {
+        return _mm256_set1_ps(value);
+    }
+    static V Add(V a, V b) {
+        return _mm256_add_ps(a, b);
+    }
+    static V Sub(V a, V b) {
+        return _mm256_sub_ps(a, b);
+    }
+    static V Mul(V a, V b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static V MulAdd(V a, V b, V c) {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+};
+
+__m256 Combine(__m128 low, __m128 high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+size_t BuildAvx2(
+    const glm::mat4* vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 q_low[4], q_high[4];
+        __m128 p_low[3], p_high[3];
+        LoadSoa4(positions + i, rotations + i, q_low, p_low);
+        LoadSoa4(positions + i + 4, rotations + i + 4, q_high, p_high);
+
+        __m256 q[4];
+        __m256 p[3];
+        for (int k = 0; k < 4; ++k) {
+            q[k] = Combine(q_low[k], q_high[k]);
+        }
+        for (int k = 0; k < 3; ++k) {
+            p[k] = Combine(p_low[k], p_high[k]);
+        }
+
+        TSoaTransform<TAvxOps> t;
+        ComputeModel<TAvxOps>(q, p, t);
+        if (vp) {
+            ComputeMvp<TAvxOps>(*vp, t);
+        }
+
+        // NOTE: matrices are written back four at a time
+        for (int half = 0; half < 2; ++half) {
+            auto extract = [half](__m256 value) {
+                return half ? _mm256_extractf128_ps(value, 1)
+                            : _mm256_castps256_ps128(value);
+            };
+
+            __m128 model[4][3];
+            __m128 mvp[4][4];
+            for (int c = 0; c < 4; ++c) {
+                for (int r = 0; r < 3; ++r) {
+                    model[c][r] = extract(t.model[c][r]);
+                }
+                for (int r = 0; vp && r < 4; ++r) {
+                    mvp[c][r] = extract(t.mvp[c][r]);
+                }
+            }
+
+            auto offset = i + 4 * half;
+            StoreSoa4(
+                model,
+                mvp,
+                vp != nullptr,
+                models + offset,
+                vp ? mvps + offset : nullptr
+            );
+        }
+    }
+    return i;
+}
+
+#endif  // GACHIBALL_TRANSFORM_AVX2
+
+#endif  // GACHIBALL_TRANSFORM_SSE
+
+void Build(
+    const glm::mat4* vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    size_t done = 0;
+#if defined(GACHIBALL_TRANSFORM_AVX2)
+    done = BuildAvx2(vp, positions, rotations, count, models, mvps);
+#endif
+#if defined(GACHIBALL_TRANSFORM_SSE)
+    done += BuildSse(
+        vp,
+        positions + done,
+        rotations + done,
+        count - done,
+        models + done,
+        vp ? mvps + done : nullptr
+    );
+#endif
+    BuildScalar(
+        vp,
+        positions + done,
+        rotations + done,
+        count - done,
+        models + done,
+        vp ? mvps + done : nullptr
+    );
+}
+
+}  // namespace
+
+void BuildModelMatrices(
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models
+) {
+    Build(nullptr, positions, rotations, count, models, nullptr);
+}
+
+void BuildModelMvpMatrices(
+    const glm::mat4& vp,
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    size_t count,
+    glm::mat4* models,
+    glm::mat4* mvps
+) {
+    Build(&vp, positions, rotations, count, models, mvps);
+}
+
+void MultiplyMatrices(
+    const glm::mat4& lhs, const glm::mat4* rhs, size_t count, glm::mat4* out
+) {
+#if defined(GACHIBALL_TRANSFORM_SSE)
+    __m128 columns[4];
+    for (int k = 0; k < 4; ++k) {
+        columns[k] = _mm_loadu_ps(&lhs[k][0]);
+    }
+
+    // NOTE: out[j] = sum_k lhs[k] * rhs[j][k]
+    for (size_t i = 0; i < count; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            auto acc = _mm_mul_ps(columns[0], _mm_set1_ps(rhs[i][j][0]));
+            acc = TSseOps::MulAdd(columns[1], _mm_set1_ps(rhs[i][j][1]), acc);
+            acc = TSseOps::MulAdd(columns[2], _mm_set1_ps(rhs[i][j][2]), acc);
+            acc = TSseOps::MulAdd(columns[3], _mm_set1_ps(rhs[i][j][3]), acc);
+            _mm_storeu_ps(&out[i][j][0], acc);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = lhs * rhs[i];
+    }
+#endif
+}
+
+const char* TransformBatchBackend() {
+#if defined(GACHIBALL_TRANSFORM_AVX2)
+    return "avx2";
+#elif defined(GACHIBALL_TRANSFORM_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+}  // namespace NGameEngine
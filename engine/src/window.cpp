@@ -4,6 +4,8 @@
 
 #include <iostream>
 
+#include "profiler.hpp"
+
 namespace NGameEngine {
 
 class TWindowImpl {
@@ -13,15 +15,19 @@ class TWindowImpl {
   public:
     virtual std::pair<int, int> window_size() const           = 0;
     virtual std::pair<double, double> cursor_position() const = 0;
+    virtual bool focused() const                              = 0;
+    virtual bool hidden() const                               = 0;
 
   public:
     virtual bool shouldClose() = 0;
 
-    virtual void bindCurrentContext() = 0;
-    virtual void swapBuffers()        = 0;
+    virtual std::unique_ptr<TWindowImpl> makeSharedContext() = 0;
+    virtual void bindCurrentContext()                        = 0;
+    virtual void swapBuffers()                               = 0;
 
-    virtual void grabCursor()   = 0;
-    virtual void ungrabCursor() = 0;
+    virtual void grabCursor()           = 0;
+    virtual void ungrabCursor()         = 0;
+    virtual bool enableRawMouseMotion() = 0;
 
     virtual void registerKeyboardKeyCallback(TKeyboardKeyCallback callback) = 0;
     virtual void registerMouseKeyCallback(TMouseKeyCallback callback)       = 0;
@@ -37,15 +43,19 @@ class TGLFWWindow : public TWindowImpl {
   public:
     std::pair<int, int> window_size() const override;
     virtual std::pair<double, double> cursor_position() const override;
+    bool focused() const override;
+    bool hidden() const override;
 
   public:
     bool shouldClose() override;
 
+    std::unique_ptr<TWindowImpl> makeSharedContext() override;
     void bindCurrentContext() override;
     void swapBuffers() override;
 
     void grabCursor() override;
     void ungrabCursor() override;
+    bool enableRawMouseMotion() override;
 
     void registerKeyboardKeyCallback(TKeyboardKeyCallback callback) override;
     void registerMouseKeyCallback(TMouseKeyCallback callback) override;
@@ -78,15 +88,38 @@ std::pair<double, double> TGLFWWindow::cursor_position() const {
     return {xpos, ypos};
 }
 
+bool TGLFWWindow::focused() const {
+    return glfwGetWindowAttrib(window_, GLFW_FOCUSED);
+}
+
+bool TGLFWWindow::hidden() const {
+    return glfwGetWindowAttrib(window_, GLFW_ICONIFIED) ||
+           !glfwGetWindowAttrib(window_, GLFW_VISIBLE);
+}
+
 bool TGLFWWindow::shouldClose() {
     return glfwWindowShouldClose(window_);
 }
 
+std::unique_ptr<TWindowImpl> TGLFWWindow::makeSharedContext() {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    auto window = glfwCreateWindow(1, 1, "GachiBall loader", NULL, window_);
+    if (!window) {
+        std::cerr << "Failed to create shared context" << std::endl;
+        return nullptr;
+    }
+    return std::make_unique<TGLFWWindow>(window);
+}
+
 void TGLFWWindow::bindCurrentContext() {
     glfwMakeContextCurrent(window_);
 }
 
 void TGLFWWindow::swapBuffers() {
+    GACHIBALL_PROFILE_ZONE("swap buffers");
     glfwSwapBuffers(window_);
 }
 
@@ -98,6 +131,14 @@ void TGLFWWindow::ungrabCursor() {
     glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 }
 
+bool TGLFWWindow::enableRawMouseMotion() {
+    if (!glfwRawMouseMotionSupported()) {
+        return false;
+    }
+    glfwSetInputMode(window_, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+    return true;
+}
+
 void TGLFWWindow::registerKeyboardKeyCallback(TKeyboardKeyCallback callback) {
     glfwSetKeyCallback(window_, reinterpret_cast<GLFWkeyfun>(callback));
 }
@@ -120,11 +161,12 @@ static void ErrorCallback(int error, const char* description) {
     std::cerr << "Error: %s\n" << description << std::endl;
 }
 
-std::unique_ptr<TWindow> TWindow::MakeGLFWWindow() {
+std::unique_ptr<TWindow> TWindow::MakeGLFWWindow(bool visible) {
     glfwSetErrorCallback(ErrorCallback);
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
     auto window = glfwCreateWindow(640, 480, "GachiBall", NULL, NULL);
     if (!window) {
@@ -158,10 +200,30 @@ std::pair<double, double> TWindow::cursor_position() const {
     return impl_->cursor_position();
 }
 
+bool TWindow::focused() const {
+    return impl_->focused();
+}
+
+bool TWindow::hidden() const {
+    return impl_->hidden();
+}
+
 bool TWindow::shouldClose() {
     return impl_->shouldClose();
 }
 
+std::unique_ptr<TWindow> TWindow::makeSharedContext() {
+    auto impl = impl_->makeSharedContext();
+    if (!impl) {
+        return nullptr;
+    }
+    return std::unique_ptr<TWindow>{new TWindow(std::move(impl))};
+}
+
+void TWindow::ReleaseCurrentContext() {
+    glfwMakeContextCurrent(NULL);
+}
+
 void TWindow::bindCurrentContext() {
     return impl_->bindCurrentContext();
 }
@@ -178,6 +240,10 @@ void TWindow::ungrabCursor() {
     impl_->ungrabCursor();
 }
 
+bool TWindow::enableRawMouseMotion() {
+    return impl_->enableRawMouseMotion();
+}
+
 void TWindow::registerKeyboardKeyCallback(TKeyboardKeyCallback callback) {
     impl_->registerKeyboardKeyCallback(std::move(callback));
 }
@@ -22,11 +22,11 @@ class TGame : public NGameEngine::IGame {
     void lose();
     void win();
 
-    void initKeyMap();
+    void initActions();
 
   private:
-    NGameEngine::TRigidBody platform_;
-    NGameEngine::TRigidBody ball_;
+    NGameEngine::TEntity platform_;
+    NGameEngine::TEntity ball_;
 
     std::vector<std::unique_ptr<NGameEngine::IMesh>> meshes_;
 
@@ -34,8 +34,12 @@ class TGame : public NGameEngine::IGame {
 
     NGameEngine::TGameEngine* engine_;
 
-    int z_rotation_factor_ = 0;
-    int x_rotation_factor_ = 0;
+    NGameEngine::TActionId tilt_x_action_         = NGameEngine::kInvalidAction;
+    NGameEngine::TActionId tilt_z_action_         = NGameEngine::kInvalidAction;
+    NGameEngine::TActionId restart_action_        = NGameEngine::kInvalidAction;
+    NGameEngine::TActionId camera_drag_action_    = NGameEngine::kInvalidAction;
+    NGameEngine::TActionId export_profile_action_ = NGameEngine::kInvalidAction;
+    NGameEngine::TEventSubscription camera_move_subscription_;
 };
 
 }  // namespace NGachiBall
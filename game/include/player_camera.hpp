@@ -10,16 +10,29 @@ class TPlayerCamera : public NGameEngine::ICamera {
     ~TPlayerCamera() = default;
 
     glm::mat4x4 view() const override;
+    glm::mat4x4 latchedView(float x_delta, float y_delta) const override;
 
     void move(float x_delta, float y_delta);
     void reset();
 
+    // NOTE: while dragged, cursor motion moves the camera and is late
+    // latched into the view
+    void setDragged(bool dragged);
+
+  private:
+    void updateView();
+
   private:
     glm::vec3 look_to_;
 
     float distance_;
     float alpha_;
     float theta_;
+
+    bool dragged_ = false;
+
+    // NOTE: rebuilt only when the camera moves
+    glm::mat4x4 view_;
 };
 
 }  // namespace NGachiBall
@@ -12,68 +12,90 @@ TGame::TGame(NGameEngine::TGameEngine* engine)
 }
 
 void TGame::deinit() {
+    engine_->unregisterInputCallback(camera_move_subscription_);
     camera_.reset();
 
-    engine_->removeBody(&platform_);
-    engine_->removeBody(&ball_);
+    engine_->removeBody(platform_);
+    engine_->removeBody(ball_);
 
-    platform_ = NGameEngine::TRigidBody{};
-    ball_     = NGameEngine::TRigidBody{};
+    platform_ = NGameEngine::kInvalidEntity;
+    ball_     = NGameEngine::kInvalidEntity;
 }
 
 void TGame::init() {
     assert(!camera_);
 
+    // NOTE: loaded in the background, the bodies show up a few frames later
     meshes_.resize(2);
     if (!meshes_[0]) {
-        meshes_[0] = NGameEngine::CreatePlatformMesh();
+        meshes_[0] = engine_->loadMesh(NGameEngine::PlatformMeshSource);
     }
     if (!meshes_[1]) {
-        meshes_[1] = NGameEngine::CreateBallMesh();
+        meshes_[1] = engine_->loadMesh(NGameEngine::BallMeshSource);
     }
 
-    platform_ = NGameEngine::TRigidBody{{
-        .mesh     = meshes_[0].get(),
+    auto& world = engine_->world();
+
+    platform_ = engine_->addBody({
         .position = {0.f, 0.f, 0.f},
         .rotation = glm::quat_cast(glm::identity<glm::mat4x4>()),
-    }};
-
-    platform_.mass     = 0.f;
-    platform_.mass_inv = 0.f;
-    engine_->addBody(&platform_);
+    });
+    world.add(platform_, NGameEngine::TMeshRef{meshes_[0].get()});
 
-    ball_ = NGameEngine::TRigidBody{{
-        .mesh     = meshes_[1].get(),
+    ball_ = engine_->addBody({
         .position = {0.f, 5.f, 0.f},
         .rotation = glm::quat_cast(glm::identity<glm::mat4x4>()),
-    }};
-
-    ball_.mass     = 1.f;
-    ball_.mass_inv = 1.f;
-
-    engine_->addBody(&ball_);
+    });
+    world.add(
+        ball_,
+        NGameEngine::TMeshRef{meshes_[1].get()},
+        NGameEngine::TVelocity{},
+        NGameEngine::TMass{.mass = 1.f, .mass_inv = 1.f}
+    );
 
     camera_ = std::make_unique<NGachiBall::TPlayerCamera>(glm::vec3{0, 0, 0});
     engine_->bindCamera(camera_.get());
 
-    initKeyMap();
+    initActions();
 }
 
 void TGame::update(float dt) {
     constexpr float kRotationSpeed = 1.f;
 
-    platform_.rotation = glm::rotate(
-        platform_.rotation,
-        kRotationSpeed * dt * x_rotation_factor_,
+    const auto& actions = engine_->actions();
+    if (actions.pressed(restart_action_)) {
+        restart();
+        return;
+    }
+
+    if (actions.pressed(export_profile_action_)) {
+        engine_->exportProfile();
+    }
+
+    if (actions.pressed(camera_drag_action_)) {
+        engine_->grabCursor();
+        camera_->setDragged(true);
+    }
+    if (actions.released(camera_drag_action_)) {
+        engine_->ungrabCursor();
+        camera_->setDragged(false);
+        camera_->reset();
+    }
+
+    auto& world        = engine_->world();
+    auto* platform     = world.get<NGameEngine::TTransform>(platform_);
+    platform->rotation = glm::rotate(
+        platform->rotation,
+        kRotationSpeed * dt * actions.value(tilt_x_action_),
         {1.f, 0.f, 0.f}
     );
-    platform_.rotation = glm::rotate(
-        platform_.rotation,
-        kRotationSpeed * dt * z_rotation_factor_,
+    platform->rotation = glm::rotate(
+        platform->rotation,
+        kRotationSpeed * dt * actions.value(tilt_z_action_),
         {0.f, 0.f, 1.f}
     );
 
-    if (ball_.position.y < -5.f) {
+    if (world.get<NGameEngine::TTransform>(ball_)->position.y < -5.f) {
         lose();
     }
 }
@@ -93,126 +115,31 @@ void TGame::win() {
     restart();
 }
 
-void TGame::initKeyMap() {
+void TGame::initActions() {
     using namespace NGameEngine;
-    // TODO: replace this copy paste with .txt file and function aliases
-
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_SPACE,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent) { this->restart(); }
-    );
-
-    // Rotation around Z axis
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_A,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent) { this->z_rotation_factor_ += 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_A,
-            .key_action   = EKeyAction::RELEASED,
-        },
-        [this](TInputEvent) { this->z_rotation_factor_ -= 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_D,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent) { this->z_rotation_factor_ -= 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_D,
-            .key_action   = EKeyAction::RELEASED,
-        },
-        [this](TInputEvent) { this->z_rotation_factor_ += 1; }
-    );
 
-    // Rotation around X axis
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_S,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent) { this->x_rotation_factor_ += 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_S,
-            .key_action   = EKeyAction::RELEASED,
-        },
-        [this](TInputEvent) { this->x_rotation_factor_ -= 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_W,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent) { this->x_rotation_factor_ -= 1; }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::KEYBOARD,
-            .key          = EKey::KEY_W,
-            .key_action   = EKeyAction::RELEASED,
-        },
-        [this](TInputEvent) { this->x_rotation_factor_ += 1; }
-    );
+    const auto& actions    = engine_->actions();
+    tilt_x_action_         = actions.action("TiltX");
+    tilt_z_action_         = actions.action("TiltZ");
+    restart_action_        = actions.action("Restart");
+    camera_drag_action_    = actions.action("CameraDrag");
+    export_profile_action_ = actions.action("ExportProfile");
 
-    // Camera control
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
-            .input_device = EInputDevice::MOUSE,
-            .key          = EKey::MOUSE_LEFT,
-            .key_action   = EKeyAction::PRESSED,
-        },
-        [this](TInputEvent event) {
-            event.context.window->grabCursor();
-            engine_->registerInputCallback(
-                NGameEngine::TInputEventType{
-                    .input_device = EInputDevice::MOUSE,
-                    .key          = EKey::MOUSE,
-                    .key_action   = EKeyAction::MOVED,
-                },
-                [this](TInputEvent move_event) {
-                    auto xdelta = move_event.context.mouse.curr_xpos -
-                                  move_event.context.mouse.prev_xpos;
-                    auto ydelta = move_event.context.mouse.curr_ypos -
-                                  move_event.context.mouse.prev_ypos;
-                    camera_->move(xdelta, ydelta);
-                }
-            );
-        }
-    );
-    engine_->registerInputCallback(
-        NGameEngine::TInputEventType{
+    camera_move_subscription_ = engine_->registerInputCallback(
+        TInputEventType{
             .input_device = EInputDevice::MOUSE,
-            .key          = EKey::MOUSE_LEFT,
-            .key_action   = EKeyAction::RELEASED,
+            .key          = EKey::MOUSE,
+            .key_action   = EKeyAction::MOVED,
         },
-        [this](TInputEvent event) {
-            event.context.window->ungrabCursor();
-            engine_->unregisterInputCallback(NGameEngine::TInputEventType{
-                .input_device = EInputDevice::MOUSE,
-                .key          = EKey::MOUSE,
-                .key_action   = EKeyAction::MOVED,
-            });
-            camera_->reset();
+        [this](const TInputEvent& event) {
+            if (!engine_->actions().held(camera_drag_action_)) {
+                return;
+            }
+            auto xdelta =
+                event.context.mouse.curr_xpos - event.context.mouse.prev_xpos;
+            auto ydelta =
+                event.context.mouse.curr_ypos - event.context.mouse.prev_ypos;
+            camera_->move(xdelta, ydelta);
         }
     );
 }
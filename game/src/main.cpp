@@ -1,15 +1,73 @@
 #include <GLFW/glfw3.h>
 
+#include <cstring>
 #include <glm/trigonometric.hpp>
+#include <iostream>
+#include <string>
 
 #include "engine.hpp"
 #include "gachiball.hpp"
 
-int main() {
+namespace {
+
+void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--record <trace>] [--playback <trace>]"
+                 " [--fixed-dt <seconds>] [--fps <rate>]"
+                 " [--swap-interval <frames>] [--profile <trace>]"
+                 " [--metrics <path.jsonl|path.csv|->]"
+                 " [--introspect <socket>]"
+              << std::endl;
+}
+
+bool ParseArgs(int argc, char** argv, NGameEngine::TEngineSettings* settings) {
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--record") && has_value) {
+            settings->input.record_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--playback") && has_value) {
+            settings->input.playback_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--fixed-dt") && has_value) {
+            settings->fixed_frame_time = std::stod(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--fps") && has_value) {
+            settings->frame_pacing.target_frame_rate = std::stod(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--swap-interval") && has_value) {
+            settings->frame_pacing.swap_interval = std::stoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--profile") && has_value) {
+            settings->profile_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--metrics") && has_value) {
+            std::string path          = argv[++i];
+            settings->metrics.enabled = true;
+            settings->metrics.path    = path == "-" ? "" : path;
+            if (path.ends_with(".csv")) {
+                settings->metrics.format = NGameEngine::EMetricsFormat::CSV;
+            }
+        } else if (!std::strcmp(argv[i], "--introspect") && has_value) {
+            settings->introspection.socket_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    NGameEngine::TEngineSettings settings;
+    if (!ParseArgs(argc, argv, &settings)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
     NGameEngine::TGameEngine engine;
     NGachiBall::TGame game{&engine};
 
-    engine.init();
+    engine.init(std::move(settings));
+    if (!engine.loadActionMap(GACHIBALL_RESOURCES_DIR "/bindings.txt")) {
+        engine.deinit();
+        return 1;
+    }
     engine.run(&game);
     engine.deinit();
 
@@ -15,28 +15,57 @@ TPlayerCamera::TPlayerCamera(glm::vec3 look_to)
     , distance_(kDefaultDistance)
     , alpha_(kInitAlpha)
     , theta_(kInitTheta) {
+    updateView();
+}
+
+static glm::mat4x4 BuildView(
+    glm::vec3 look_to, float distance, float alpha, float theta
+) {
+    glm::vec3 position = distance * glm::vec3{
+                                        glm::sin(alpha) * glm::cos(theta),
+                                        glm::sin(theta),
+                                        glm::cos(alpha) * glm::cos(theta)
+                                    };
+
+    glm::vec3 up = glm::vec3{0.f, glm::cos(theta), 0.f};
+
+    return glm::lookAt(position, look_to, up);
 }
 
 glm::mat4x4 TPlayerCamera::view() const {
-    glm::vec3 position = distance_ * glm::vec3{
-                                         glm::sin(alpha_) * glm::cos(theta_),
-                                         glm::sin(theta_),
-                                         glm::cos(alpha_) * glm::cos(theta_)
-                                     };
+    return view_;
+}
 
-    glm::vec3 up = glm::vec3{0.f, glm::cos(theta_), 0.f};
+glm::mat4x4 TPlayerCamera::latchedView(float x_delta, float y_delta) const {
+    if (!dragged_ || (x_delta == 0.f && y_delta == 0.f)) {
+        return view_;
+    }
+    return BuildView(
+        look_to_,
+        distance_,
+        alpha_ - glm::radians(x_delta) * kRotationSpeed,
+        theta_ + glm::radians(y_delta) * kRotationSpeed
+    );
+}
 
-    return glm::lookAt(position, look_to_, up);
+void TPlayerCamera::updateView() {
+    view_ = BuildView(look_to_, distance_, alpha_, theta_);
 }
 
 void TPlayerCamera::move(float x_delta, float y_delta) {
     alpha_ -= glm::radians(x_delta) * kRotationSpeed;
     theta_ += glm::radians(y_delta) * kRotationSpeed;
+    updateView();
+}
+
+void TPlayerCamera::setDragged(bool dragged) {
+    dragged_ = dragged;
 }
 
 void TPlayerCamera::reset() {
     alpha_ = kInitAlpha;
     theta_ = kInitTheta;
+    updateView();
 }
 
 }  // namespace NGachiBall
@@ -0,0 +1,267 @@
+#include <execinfo.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <glm/gtc/quaternion.hpp>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "allocation_scope.hpp"
+#include "engine.hpp"
+
+// NOTE: runs the engine headless with a small scene and hooks the global
+// operator new to catch heap allocations in steady state frames. Strict mode
+// prints the stack of the first one and fails, otherwise allocations are
+// counted per engine subsystem. Subsystems are only labelled when the engine
+// is built with GACHIBALL_TRACK_ALLOCATIONS, link with exported symbols for
+// readable stacks.
+// usage: alloc_check [--frames N] [--warmup N] [--strict]
+
+namespace {
+
+static constexpr size_t kMaxScopes     = 16;
+static constexpr int kMaxStackDepth    = 64;
+static constexpr const char* kUnscoped = "unscoped";
+
+struct TScopeCounter {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> bytes{0};
+};
+
+std::atomic<bool> armed{false};
+bool strict = false;
+std::array<TScopeCounter, kMaxScopes> counters;
+thread_local bool in_hook = false;
+
+TScopeCounter& CounterOf(const char* name) {
+    for (auto& counter : counters) {
+        auto* current = counter.name.load(std::memory_order_acquire);
+        if (!current && counter.name.compare_exchange_strong(current, name)) {
+            return counter;
+        }
+        // NOTE: a failed exchange loads the name another thread claimed
+        if (current == name) {
+            return counter;
+        }
+    }
+    // NOTE: out of counters, lump the rest together
+    return counters.back();
+}
+
+void WriteError(const char* message) {
+    auto unused = write(STDERR_FILENO, message, std::strlen(message));
+    (void)unused;
+}
+
+void OnAllocation(size_t size) {
+    if (!armed.load(std::memory_order_relaxed) || in_hook) {
+        return;
+    }
+    in_hook = true;
+
+    auto* scope = NGameEngine::CurrentAllocationScope();
+    if (!scope) {
+        scope = kUnscoped;
+    }
+
+    if (strict) {
+        // NOTE: no allocations from here on, backtrace was warmed up in main
+        armed = false;
+        WriteError("Heap allocation in a steady state frame, scope: ");
+        WriteError(scope);
+        WriteError("\n");
+        std::array<void*, kMaxStackDepth> stack;
+        auto depth = backtrace(stack.data(), kMaxStackDepth);
+        backtrace_symbols_fd(stack.data(), depth, STDERR_FILENO);
+        std::_Exit(1);
+    }
+
+    auto& counter = CounterOf(scope);
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(size, std::memory_order_relaxed);
+    in_hook = false;
+}
+
+class TProbeGame : public NGameEngine::IGame {
+  public:
+    TProbeGame(NGameEngine::TGameEngine* engine, size_t warmup_frames)
+        : engine_(engine)
+        , warmup_frames_(warmup_frames) {
+    }
+
+    void init() override {
+        using namespace NGameEngine;
+
+        camera_ = CreateRotatingCamera({0.f, 0.f, 0.f}, 0.f, 20.f);
+        engine_->bindCamera(camera_.get());
+
+        platform_mesh_ = CreatePlatformMesh();
+        ball_mesh_     = CreateBallMesh();
+
+        auto& world = engine_->world();
+        platform_   = engine_->addBody({});
+        world.add(platform_, TMeshRef{platform_mesh_.get()});
+        for (int i = 0; i < 16; ++i) {
+            auto ball = engine_->addBody({
+                .position = {static_cast<float>(i % 4), 5.f, i / 4.f},
+            });
+            world.add(
+                ball,
+                TMeshRef{ball_mesh_.get()},
+                TVelocity{},
+                TMass{.mass = 1.f, .mass_inv = 1.f}
+            );
+        }
+
+        // NOTE: exercises the input and event paths every frame
+        subscription_ = engine_->registerInputCallback(
+            TInputEventType{
+                .input_device = EInputDevice::MOUSE,
+                .key          = EKey::MOUSE,
+                .key_action   = EKeyAction::MOVED,
+            },
+            [this](const TInputEvent&) { ++mouse_events_; }
+        );
+        auto& bus            = engine_->eventBus();
+        resize_subscription_ = bus.subscribe<TWindowResizeEvent>(
+            [this](std::span<const TWindowResizeEvent> events) {
+                resize_events_ += events.size();
+            }
+        );
+    }
+
+    void update(float dt) override {
+        using namespace NGameEngine;
+
+        auto* platform     = engine_->world().get<TTransform>(platform_);
+        platform->rotation =
+            glm::rotate(platform->rotation, dt, {1.f, 0.f, 0.f});
+        engine_->eventBus().publish(TWindowResizeEvent{1, 1});
+
+        if (++frames_ == warmup_frames_) {
+            armed = true;
+        }
+    }
+
+    void deinit() override {
+        armed = false;
+
+        engine_->eventBus().unsubscribe(resize_subscription_);
+        engine_->unregisterInputCallback(subscription_);
+    }
+
+  public:
+    // getters
+    size_t steadyFrames() const {
+        return frames_ > warmup_frames_ ? frames_ - warmup_frames_ : 0;
+    }
+
+  private:
+    NGameEngine::TGameEngine* engine_;
+    size_t warmup_frames_;
+    size_t frames_ = 0;
+
+    std::unique_ptr<NGameEngine::ICamera> camera_;
+    std::unique_ptr<NGameEngine::IMesh> platform_mesh_;
+    std::unique_ptr<NGameEngine::IMesh> ball_mesh_;
+    NGameEngine::TEntity platform_;
+
+    NGameEngine::TEventSubscription subscription_;
+    NGameEngine::TEventBusSubscription resize_subscription_;
+    size_t mouse_events_  = 0;
+    size_t resize_events_ = 0;
+};
+
+}  // namespace
+
+void* operator new(size_t size) {
+    OnAllocation(size);
+    if (auto* memory = std::malloc(size ? size : 1); memory) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    OnAllocation(size);
+    auto align = static_cast<size_t>(alignment);
+    // NOTE: aligned_alloc wants the size to be a multiple of the alignment
+    auto padded = (size + align - 1) & ~(align - 1);
+    if (auto* memory = std::aligned_alloc(align, padded ? padded : align);
+        memory) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char** argv) {
+    size_t frames = 600;
+    size_t warmup = 120;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--frames") && has_value) {
+            frames = std::stoul(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--warmup") && has_value) {
+            warmup = std::stoul(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--strict")) {
+            strict = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--frames N] [--warmup N] [--strict]" << std::endl;
+            return 1;
+        }
+    }
+
+    // NOTE: the first backtrace loads the unwinder and allocates
+    std::array<void*, kMaxStackDepth> stack;
+    backtrace(stack.data(), kMaxStackDepth);
+
+    NGameEngine::TEngineSettings settings;
+    settings.headless                   = true;
+    settings.frame_limit                = warmup + frames;
+    settings.fixed_frame_time           = 1. / 60.;
+    settings.frame_pacing.swap_interval = 0;
+
+    NGameEngine::TGameEngine engine;
+    TProbeGame game{&engine, warmup};
+
+    engine.init(std::move(settings));
+    engine.run(&game);
+    engine.deinit();
+
+    size_t total = 0;
+    std::cout << "steady state frames: " << game.steadyFrames() << std::endl;
+    for (const auto& counter : counters) {
+        auto* name = counter.name.load();
+        if (!name) {
+            break;
+        }
+        total += counter.count;
+        std::cout << name << ": " << counter.count << " allocations, "
+                  << counter.bytes << " bytes" << std::endl;
+    }
+    std::cout << "total: " << total << " allocations" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "event_dispatcher.hpp"
+
+// NOTE: measures event dispatch cost and checks that dispatching does not
+// allocate, usage: dispatch_bench [subscribers] [events]
+
+namespace {
+
+using TClock = std::chrono::steady_clock;
+
+size_t allocation_count = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (auto* memory = std::malloc(size ? size : 1); memory) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char** argv) {
+    using namespace NGameEngine;
+
+    size_t subscribers = argc > 1 ? std::stoul(argv[1]) : 4;
+    size_t events      = argc > 2 ? std::stoul(argv[2]) : 10000000;
+
+    TEventDispatcher dispatcher;
+
+    auto moved = TInputEventType{
+        .input_device = EInputDevice::MOUSE,
+        .key          = EKey::MOUSE,
+        .key_action   = EKeyAction::MOVED,
+    };
+    double sum = 0.;
+    for (size_t i = 0; i < subscribers; ++i) {
+        dispatcher.subscribe(moved, [&sum, i](const TInputEvent& event) {
+            sum += event.context.mouse.curr_xpos + static_cast<double>(i);
+        });
+    }
+    // NOTE: unrelated subscriptions make the lookup realistic
+    for (auto key : {EKey::KEY_A, EKey::KEY_D, EKey::KEY_S, EKey::KEY_W}) {
+        for (auto action : {EKeyAction::PRESSED, EKeyAction::RELEASED}) {
+            dispatcher.subscribe(
+                TInputEventType{
+                    .input_device = EInputDevice::KEYBOARD,
+                    .key          = key,
+                    .key_action   = action,
+                },
+                [&sum](const TInputEvent&) { sum += 1.; }
+            );
+        }
+    }
+
+    auto event = MakeEvent(TInputEvent{.type = moved});
+
+    auto allocations_before = allocation_count;
+    auto start              = TClock::now();
+    for (size_t i = 0; i < events; ++i) {
+        std::get<TInputEvent>(event).context.mouse.curr_xpos =
+            static_cast<double>(i);
+        dispatcher.raiseEvent(event);
+    }
+    std::chrono::duration<double, std::nano> elapsed = TClock::now() - start;
+    auto allocations = allocation_count - allocations_before;
+
+    auto ns_per_event   = elapsed.count() / static_cast<double>(events);
+    auto ns_per_handler = ns_per_event / static_cast<double>(
+                                             subscribers ? subscribers : 1
+                                         );
+    std::cout << "subscribers: " << subscribers << ", events: " << events
+              << std::endl
+              << "dispatch: " << ns_per_event << " ns/event, "
+              << ns_per_handler << " ns/handler" << std::endl
+              << "allocations during dispatch: " << allocations << std::endl
+              << "checksum: " << sum << std::endl;
+
+    return allocations == 0 ? 0 : 1;
+}
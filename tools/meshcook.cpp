@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mesh_asset.hpp"
+
+// NOTE: converts an OBJ file to the cooked mesh format loaded by LoadMesh,
+// usage: meshcook <input.obj> <output.mesh> [--cache-size N]
+// Triangles are reordered for the post transform vertex cache, vertices are
+// reordered by first use and positions are quantized to the bounds.
+
+namespace {
+
+using namespace NGameEngine;
+
+static constexpr size_t kDefaultCacheSize = 32;
+static constexpr float kQuantizationScale = 32767.f;
+
+static constexpr std::array<float, 4> kDefaultColor = {1.f, 0.5f, 0.2f, 1.f};
+
+struct TObjVertex {
+    std::array<float, 3> position;
+    std::array<float, 4> color;
+};
+
+struct TObjMesh {
+    std::vector<TObjVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// NOTE: a face corner is "v", "v/vt", "v//vn" or "v/vt/vn", only the
+// position index is used. Negative indices count from the last vertex.
+bool ParseCorner(const std::string& token, size_t vertex_count, uint32_t* out) {
+    char* end         = nullptr;
+    long index        = std::strtol(token.c_str(), &end, 10);
+    auto signed_count = static_cast<long>(vertex_count);
+    if (end == token.c_str() || (*end != '\0' && *end != '/')) {
+        return false;
+    }
+    if (index < 0) {
+        index += signed_count + 1;
+    }
+    if (index < 1 || index > signed_count) {
+        return false;
+    }
+    *out = static_cast<uint32_t>(index - 1);
+    return true;
+}
+
+bool ParseObj(std::istream& in, TObjMesh& mesh) {
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        std::istringstream words{line};
+        std::string kind;
+        words >> kind;
+
+        if (kind == "v") {
+            TObjVertex vertex{.position = {}, .color = kDefaultColor};
+            auto& p = vertex.position;
+            if (!(words >> p[0] >> p[1] >> p[2])) {
+                std::cerr << "line " << line_number << ": bad vertex"
+                          << std::endl;
+                return false;
+            }
+            // NOTE: vertex colors are a common extension, alpha stays opaque
+            auto& c = vertex.color;
+            if (float r, g, b; words >> r >> g >> b) {
+                c = {r, g, b, 1.f};
+            }
+            mesh.vertices.push_back(vertex);
+        } else if (kind == "f") {
+            std::vector<uint32_t> polygon;
+            for (std::string token; words >> token;) {
+                uint32_t index;
+                if (!ParseCorner(token, mesh.vertices.size(), &index)) {
+                    std::cerr << "line " << line_number << ": bad face index "
+                              << token << std::endl;
+                    return false;
+                }
+                polygon.push_back(index);
+            }
+            if (polygon.size() < 3) {
+                std::cerr << "line " << line_number << ": degenerate face"
+                          << std::endl;
+                return false;
+            }
+            // NOTE: polygons are assumed convex and fanned
+            for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+                mesh.indices.insert(
+                    mesh.indices.end(), {polygon[0], polygon[i], polygon[i + 1]}
+                );
+            }
+        }
+        // NOTE: normals, texture coordinates, groups and materials are not
+        // used by the engine shaders
+    }
+    return true;
+}
+
+// NOTE: misses per triangle of a FIFO cache, the closest simple model of
+// the post transform cache
+double AverageCacheMissRatio(
+    const std::vector<uint32_t>& indices, size_t vertex_count, size_t cache_size
+) {
+    std::vector<size_t> inserted_at(vertex_count, 0);
+    size_t misses = 0;
+    for (auto index : indices) {
+        // NOTE: timestamps start at one, zero means never cached
+        auto cached =
+            inserted_at[index] && misses - inserted_at[index] < cache_size;
+        if (!cached) {
+            inserted_at[index] = ++misses;
+        }
+    }
+    return static_cast<double>(misses) / (indices.size() / 3);
+}
+
+// NOTE: Tom Forsyth, "Linear-Speed Vertex Cache Optimisation". Greedily
+// emits the triangle with the best score, where vertices score for being
+// recently used and for having few triangles left.
+class TVertexCacheOptimizer {
+  public:
+    TVertexCacheOptimizer(
+        const std::vector<uint32_t>& indices,
+        size_t vertex_count,
+        size_t cache_size
+    )
+        : indices_(indices)
+        , cache_size_(cache_size)
+        , vertices_(vertex_count)
+        , triangle_scores_(indices.size() / 3, 0.f)
+        , emitted_(indices.size() / 3, false) {
+        for (size_t triangle = 0; triangle < emitted_.size(); ++triangle) {
+            for (size_t corner = 0; corner < 3; ++corner) {
+                auto& vertex = vertices_[indices_[triangle * 3 + corner]];
+                vertex.triangles.push_back(triangle);
+                ++vertex.remaining;
+            }
+        }
+        for (auto& vertex : vertices_) {
+            vertex.score = score(vertex);
+        }
+        for (size_t triangle = 0; triangle < emitted_.size(); ++triangle) {
+            triangle_scores_[triangle] = triangleScore(triangle);
+        }
+    }
+
+    std::vector<uint32_t> optimize() {
+        std::vector<uint32_t> result;
+        result.reserve(indices_.size());
+
+        size_t next_unemitted = 0;
+        for (size_t emitted = 0; emitted < emitted_.size(); ++emitted) {
+            auto best = bestCachedTriangle();
+            if (best == kNone) {
+                // NOTE: nothing in the cache has triangles left, start at
+                // the next island
+                while (emitted_[next_unemitted]) {
+                    ++next_unemitted;
+                }
+                best = next_unemitted;
+            }
+            emit(best, result);
+        }
+        return result;
+    }
+
+  private:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    struct TVertex {
+        std::vector<size_t> triangles;
+        size_t remaining   = 0;
+        int cache_position = -1;
+        float score        = 0.f;
+    };
+
+  private:
+    float score(const TVertex& vertex) const {
+        if (!vertex.remaining) {
+            return -1.f;
+        }
+
+        float score = 0.f;
+        if (vertex.cache_position >= 0 && vertex.cache_position < 3) {
+            // NOTE: the last triangle's vertices score the same, so the
+            // winding order does not matter
+            score = 0.75f;
+        } else if (vertex.cache_position >= 3) {
+            auto scaler   = 1.f / static_cast<float>(cache_size_ - 3);
+            auto position = static_cast<float>(vertex.cache_position - 3);
+            score         = std::pow(1.f - position * scaler, 1.5f);
+        }
+        return score + 2.f / std::sqrt(static_cast<float>(vertex.remaining));
+    }
+
+    float triangleScore(size_t triangle) const {
+        float score = 0.f;
+        for (size_t corner = 0; corner < 3; ++corner) {
+            score += vertices_[indices_[triangle * 3 + corner]].score;
+        }
+        return score;
+    }
+
+    size_t bestCachedTriangle() const {
+        size_t best      = kNone;
+        float best_score = -1.f;
+        for (auto index : cache_) {
+            for (auto triangle : vertices_[index].triangles) {
+                if (!emitted_[triangle] &&
+                    triangle_scores_[triangle] > best_score) {
+                    best       = triangle;
+                    best_score = triangle_scores_[triangle];
+                }
+            }
+        }
+        return best;
+    }
+
+    void emit(size_t triangle, std::vector<uint32_t>& result) {
+        emitted_[triangle] = true;
+
+        std::array<uint32_t, 3> corners;
+        for (size_t corner = 0; corner < 3; ++corner) {
+            corners[corner] = indices_[triangle * 3 + corner];
+            result.push_back(corners[corner]);
+
+            auto& vertex = vertices_[corners[corner]];
+            --vertex.remaining;
+            std::erase(vertex.triangles, triangle);
+        }
+
+        // NOTE: LRU, the emitted corners go to the front. The cache grows by
+        // up to three entries so the evicted vertices get their scores
+        // updated too.
+        for (auto index : corners) {
+            std::erase(cache_, index);
+        }
+        cache_.insert(cache_.begin(), corners.begin(), corners.end());
+
+        for (size_t position = 0; position < cache_.size(); ++position) {
+            auto& vertex          = vertices_[cache_[position]];
+            vertex.cache_position = position < cache_size_ ? position : -1;
+            vertex.score          = score(vertex);
+        }
+        for (auto index : cache_) {
+            for (auto neighbour : vertices_[index].triangles) {
+                triangle_scores_[neighbour] = triangleScore(neighbour);
+            }
+        }
+        if (cache_.size() > cache_size_) {
+            cache_.resize(cache_size_);
+        }
+    }
+
+  private:
+    const std::vector<uint32_t>& indices_;
+    size_t cache_size_;
+
+    std::vector<TVertex> vertices_;
+    std::vector<float> triangle_scores_;
+    std::vector<bool> emitted_;
+    std::vector<uint32_t> cache_;
+};
+
+// NOTE: renumbers vertices in the order the indices first reference them,
+// so vertex fetch walks memory forward. Unreferenced vertices are dropped.
+void ReorderVertices(TObjMesh& mesh) {
+    static constexpr auto kUnassigned = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> remap(mesh.vertices.size(), kUnassigned);
+    std::vector<TObjVertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (auto& index : mesh.indices) {
+        if (remap[index] == kUnassigned) {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+uint8_t QuantizeColor(float value) {
+    return static_cast<uint8_t>(
+        std::lround(std::clamp(value, 0.f, 1.f) * 255.f)
+    );
+}
+
+template <typename T>
+void WriteBlob(std::ostream& out, const std::vector<T>& values) {
+    out.write(
+        reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)
+    );
+}
+
+void WritePadding(std::ostream& out, uint64_t offset) {
+    static constexpr std::array<char, kMeshAssetAlignment> kZeros{};
+    auto position = static_cast<uint64_t>(out.tellp());
+    out.write(kZeros.data(), offset - position);
+}
+
+bool WriteMesh(const TObjMesh& mesh, const std::string& path) {
+    TMeshAssetHeader header{
+        .magic         = kMeshAssetMagic,
+        .version       = kMeshAssetVersion,
+        .vertex_stride = sizeof(TMeshAssetVertex),
+        .index_type    = mesh.vertices.size() <= 65536 ? EMeshIndexType::UINT16
+                                                       : EMeshIndexType::UINT32,
+        .vertex_count  = static_cast<uint32_t>(mesh.vertices.size()),
+        .index_count   = static_cast<uint32_t>(mesh.indices.size()),
+    };
+
+    for (size_t axis = 0; axis < 3; ++axis) {
+        header.bounds_min[axis] = std::numeric_limits<float>::max();
+        header.bounds_max[axis] = std::numeric_limits<float>::lowest();
+        for (const auto& vertex : mesh.vertices) {
+            header.bounds_min[axis] =
+                std::min(header.bounds_min[axis], vertex.position[axis]);
+            header.bounds_max[axis] =
+                std::max(header.bounds_max[axis], vertex.position[axis]);
+        }
+    }
+
+    std::vector<TMeshAssetVertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (const auto& vertex : mesh.vertices) {
+        TMeshAssetVertex cooked{};
+        for (size_t axis = 0; axis < 3; ++axis) {
+            auto low    = header.bounds_min[axis];
+            auto high   = header.bounds_max[axis];
+            auto center = (low + high) / 2;
+            auto half   = (high - low) / 2;
+            // NOTE: a flat axis dequantizes with a zero scale to its center
+            auto normalized = std::clamp(
+                half > 0.f ? (vertex.position[axis] - center) / half : 0.f,
+                -1.f,
+                1.f
+            );
+            cooked.position[axis] = static_cast<int16_t>(
+                std::lround(normalized * kQuantizationScale)
+            );
+        }
+        for (size_t channel = 0; channel < 4; ++channel) {
+            cooked.color[channel] = QuantizeColor(vertex.color[channel]);
+        }
+        vertices.push_back(cooked);
+    }
+
+    auto index_size      = MeshIndexSize(header.index_type);
+    header.vertex_bytes  = vertices.size() * sizeof(TMeshAssetVertex);
+    header.index_bytes   = mesh.indices.size() * index_size;
+    header.vertex_offset = AlignMeshAssetOffset(sizeof(header));
+    header.index_offset =
+        AlignMeshAssetOffset(header.vertex_offset + header.vertex_bytes);
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WritePadding(out, header.vertex_offset);
+    WriteBlob(out, vertices);
+    WritePadding(out, header.index_offset);
+    if (header.index_type == EMeshIndexType::UINT16) {
+        WriteBlob(
+            out,
+            std::vector<uint16_t>(mesh.indices.begin(), mesh.indices.end())
+        );
+    } else {
+        WriteBlob(out, mesh.indices);
+    }
+
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3 && !(argc == 5 && std::string{argv[3]} == "--cache-size")) {
+        std::cerr << "usage: meshcook <input.obj> <output.mesh> "
+                     "[--cache-size N]"
+                  << std::endl;
+        return 1;
+    }
+
+    size_t cache_size = kDefaultCacheSize;
+    if (argc == 5) {
+        cache_size = std::strtoul(argv[4], nullptr, 10);
+        if (cache_size < 4) {
+            std::cerr << "cache size must be at least 4" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream in{argv[1]};
+    if (!in) {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TObjMesh mesh;
+    if (!ParseObj(in, mesh)) {
+        std::cerr << "Failed to parse " << argv[1] << std::endl;
+        return 1;
+    }
+    if (mesh.indices.empty()) {
+        std::cerr << argv[1] << " has no faces" << std::endl;
+        return 1;
+    }
+    if (mesh.vertices.size() > std::numeric_limits<uint32_t>::max() ||
+        mesh.indices.size() > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << argv[1] << " is too large" << std::endl;
+        return 1;
+    }
+
+    auto vertex_count = mesh.vertices.size();
+    auto acmr_before =
+        AverageCacheMissRatio(mesh.indices, vertex_count, cache_size);
+    TVertexCacheOptimizer optimizer{mesh.indices, vertex_count, cache_size};
+    mesh.indices = optimizer.optimize();
+    auto acmr_after =
+        AverageCacheMissRatio(mesh.indices, vertex_count, cache_size);
+    ReorderVertices(mesh);
+
+    if (!WriteMesh(mesh, argv[2])) {
+        return 1;
+    }
+    std::cout << argv[2] << ": " << mesh.vertices.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles, ACMR " << acmr_before
+              << " -> " << acmr_after << std::endl;
+    return 0;
+}
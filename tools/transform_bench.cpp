@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "transform_batch.hpp"
+
+// NOTE: compares per body glm math from the engine draw loop with the batched
+// kernels, usage: transform_bench [bodies] [iterations]
+
+namespace {
+
+using TClock = std::chrono::steady_clock;
+
+struct TScene {
+    glm::mat4 vp;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+};
+
+TScene GenerateScene(size_t count) {
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> dist{-1.f, 1.f};
+
+    TScene scene;
+    scene.vp = glm::perspective(glm::radians(45.f), 4.f / 3.f, 0.1f, 100.f) *
+               glm::lookAt(
+                   glm::vec3{0.f, 10.f, 30.f},
+                   glm::vec3{0.f, 0.f, 0.f},
+                   glm::vec3{0.f, 1.f, 0.f}
+               );
+
+    scene.positions.resize(count);
+    scene.rotations.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        scene.positions[i] = 10.f * glm::vec3{dist(rng), dist(rng), dist(rng)};
+        scene.rotations[i] = glm::normalize(
+            glm::quat{dist(rng), dist(rng), dist(rng), dist(rng)}
+        );
+    }
+    return scene;
+}
+
+template <typename TFunc>
+double MeasureNsPerBody(size_t count, size_t iterations, TFunc&& func) {
+    // NOTE: warm up caches and page in the output
+    func();
+
+    auto start = TClock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        func();
+    }
+    std::chrono::duration<double, std::nano> elapsed = TClock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations * count);
+}
+
+float MaxError(
+    const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b
+) {
+    float error = 0.f;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                error = std::max(error, std::abs(a[i][c][r] - b[i][c][r]));
+            }
+        }
+    }
+    return error;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count      = argc > 1 ? std::stoul(argv[1]) : 50000;
+    size_t iterations = argc > 2 ? std::stoul(argv[2]) : 200;
+
+    auto scene = GenerateScene(count);
+
+    std::vector<glm::mat4> glm_models(count), glm_mvps(count);
+    auto glm_ns = MeasureNsPerBody(count, iterations, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            glm_models[i] =
+                glm::translate(glm::mat4{1.f}, scene.positions[i]) *
+                glm::mat4_cast(scene.rotations[i]);
+            glm_mvps[i] = scene.vp * glm_models[i];
+        }
+    });
+
+    std::vector<glm::mat4> batch_models(count), batch_mvps(count);
+    auto batch_ns = MeasureNsPerBody(count, iterations, [&] {
+        NGameEngine::BuildModelMvpMatrices(
+            scene.vp,
+            scene.positions.data(),
+            scene.rotations.data(),
+            count,
+            batch_models.data(),
+            batch_mvps.data()
+        );
+    });
+
+    std::vector<glm::mat4> multiply_mvps(count);
+    auto multiply_ns = MeasureNsPerBody(count, iterations, [&] {
+        NGameEngine::MultiplyMatrices(
+            scene.vp, glm_models.data(), count, multiply_mvps.data()
+        );
+    });
+
+    std::cout << "bodies: " << count << ", iterations: " << iterations
+              << ", backend: " << NGameEngine::TransformBatchBackend()
+              << std::endl
+              << "glm model + mvp:   " << glm_ns << " ns/body" << std::endl
+              << "batch model + mvp: " << batch_ns << " ns/body (x"
+              << glm_ns / batch_ns << ")" << std::endl
+              << "batch vp * model:  " << multiply_ns << " ns/body"
+              << std::endl
+              << "max error: model " << MaxError(glm_models, batch_models)
+              << ", mvp " << MaxError(glm_mvps, batch_mvps) << std::endl;
+
+    return 0;
+}